@@ -0,0 +1,132 @@
+# Embeds every shader into the executable and generates reflection constants from the GLSL.
+#
+# cmake -DSHADER_DIR=<shader dir> -DOUTPUT_DIR=<output dir> [-DEMBED_SOURCES=OFF] -P EmbedShaders.cmake
+#
+# Writes
+#   OUTPUT_DIR/EmbeddedShaders.cpp  sources for getEmbeddedShaderFiles(), empty with EMBED_SOURCES=OFF
+#   OUTPUT_DIR/ShaderReflection.hpp attribute locations and uniform names, one namespace per shader directory
+
+if (NOT DEFINED SHADER_DIR OR NOT DEFINED OUTPUT_DIR)
+    message(FATAL_ERROR "EmbedShaders.cmake needs SHADER_DIR and OUTPUT_DIR")
+endif()
+
+if (NOT DEFINED EMBED_SOURCES)
+    set(EMBED_SOURCES ON)
+endif()
+
+# Only touch outputs that changed, so unchanged shaders do not cause a rebuild
+function(write_if_different path content)
+    if (EXISTS "${path}")
+        file(READ "${path}" oldContent)
+        if (oldContent STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+file(GLOB_RECURSE shaderFiles RELATIVE "${SHADER_DIR}" "${SHADER_DIR}/*.glsl")
+list(SORT shaderFiles)
+
+# Sources
+set(embedded "// Generated by cmake/EmbedShaders.cmake, do not edit\n\n")
+string(APPEND embedded "#include \"Utility/GL/EmbeddedShaders/EmbeddedShaders.hpp\"\n\n")
+
+if (EMBED_SOURCES AND shaderFiles)
+    string(APPEND embedded "static constexpr EmbeddedShaderFile embeddedShaderFiles[] = {\n")
+
+    foreach (shaderFile IN LISTS shaderFiles)
+        file(READ "${SHADER_DIR}/${shaderFile}" source)
+
+        if (source MATCHES "\\)glsl\"")
+            message(FATAL_ERROR "${shaderFile} contains the raw string delimiter )glsl\"")
+        endif()
+
+        string(APPEND embedded "    { \"${shaderFile}\", R\"glsl(${source})glsl\" },\n")
+    endforeach()
+
+    string(APPEND embedded "};\n\n")
+    string(APPEND embedded "std::span<const EmbeddedShaderFile> getEmbeddedShaderFiles() {\n    return embeddedShaderFiles;\n}\n")
+else()
+    string(APPEND embedded "std::span<const EmbeddedShaderFile> getEmbeddedShaderFiles() {\n    return {};\n}\n")
+endif()
+
+write_if_different("${OUTPUT_DIR}/EmbeddedShaders.cpp" "${embedded}")
+
+# Reflection, every directory holds the stages of one program
+set(directories "")
+foreach (shaderFile IN LISTS shaderFiles)
+    get_filename_component(directory "${shaderFile}" DIRECTORY)
+    list(APPEND directories "${directory}")
+endforeach()
+list(REMOVE_DUPLICATES directories)
+
+set(reflection "// Generated by cmake/EmbedShaders.cmake, do not edit\n")
+string(APPEND reflection "// Vertex attribute locations and uniform names of the shaders, a typo is a compile error\n\n")
+string(APPEND reflection "#pragma once\n\n#include \"glad/glad.h\"\n\nnamespace ShaderReflection {\n")
+
+foreach (directory IN LISTS directories)
+    set(attributes "")
+    set(uniforms "")
+
+    foreach (shaderFile IN LISTS shaderFiles)
+        get_filename_component(fileDirectory "${shaderFile}" DIRECTORY)
+        if (NOT fileDirectory STREQUAL directory)
+            continue()
+        endif()
+
+        file(READ "${SHADER_DIR}/${shaderFile}" source)
+
+        # Semicolons would split the matches as CMake lists
+        string(REPLACE ";" "@" source "${source}")
+
+        # layout(location=N) in type name;
+        string(REGEX MATCHALL "layout[ \t]*\\([ \t]*location[ \t]*=[ \t]*[0-9]+[ \t]*\\)[ \t]*in[ \t]+[A-Za-z0-9_]+[ \t]+[A-Za-z0-9_]+" matches "${source}")
+        foreach (match IN LISTS matches)
+            string(REGEX REPLACE ".*location[ \t]*=[ \t]*([0-9]+).*[ \t]([A-Za-z0-9_]+)$" "\\2=\\1" attribute "${match}")
+            list(APPEND attributes "${attribute}")
+        endforeach()
+
+        # uniform type name; at the start of a line, uniform blocks are skipped
+        string(REGEX MATCHALL "(^|\n)[ \t]*uniform[ \t]+[A-Za-z0-9_]+[ \t]+[A-Za-z0-9_]+[ \t]*(\\[[^]]*\\])?[ \t]*@" matches "${source}")
+        foreach (match IN LISTS matches)
+            string(REGEX REPLACE ".*uniform[ \t]+[A-Za-z0-9_]+[ \t]+([A-Za-z0-9_]+).*" "\\1" uniform "${match}")
+            list(APPEND uniforms "${uniform}")
+        endforeach()
+    endforeach()
+
+    list(REMOVE_DUPLICATES attributes)
+    list(REMOVE_DUPLICATES uniforms)
+
+    if (NOT attributes AND NOT uniforms)
+        continue()
+    endif()
+
+    string(REPLACE "/" "_" namespaceName "${directory}")
+    string(APPEND reflection "    namespace ${namespaceName} {\n")
+
+    if (attributes)
+        string(APPEND reflection "        namespace attribute {\n")
+        foreach (attribute IN LISTS attributes)
+            string(REPLACE "=" ";" attributeParts "${attribute}")
+            list(GET attributeParts 0 attributeName)
+            list(GET attributeParts 1 attributeLocation)
+            string(APPEND reflection "            constexpr GLuint ${attributeName} = ${attributeLocation};\n")
+        endforeach()
+        string(APPEND reflection "        }\n")
+    endif()
+
+    if (uniforms)
+        string(APPEND reflection "        namespace uniform {\n")
+        foreach (uniform IN LISTS uniforms)
+            string(APPEND reflection "            constexpr const char* ${uniform} = \"${uniform}\";\n")
+        endforeach()
+        string(APPEND reflection "        }\n")
+    endif()
+
+    string(APPEND reflection "    }\n")
+endforeach()
+
+string(APPEND reflection "}\n")
+
+write_if_different("${OUTPUT_DIR}/ShaderReflection.hpp" "${reflection}")
@@ -2,7 +2,7 @@
 
 layout(isolines) in;
 
-uniform mat4 viewProjection;
+#include "frame.glsl"
 
 void main() {
     float t = gl_TessCoord.x;
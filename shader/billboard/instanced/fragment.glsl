@@ -0,0 +1,12 @@
+#version 410 core
+
+out vec4 color;
+
+in vec2 outUV;
+
+// Left at its default of texture unit 0, where BillboardRenderer binds the batch texture
+uniform sampler2D myTexture;
+
+void main() {
+    color = texture(myTexture, outUV);
+}
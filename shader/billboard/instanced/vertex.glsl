@@ -0,0 +1,28 @@
+#version 410 core
+
+// Per vertex
+layout(location=0) in vec2 vertexPosition;
+layout(location=1) in vec2 inUV;
+
+// Per instance, see BillboardInstance
+layout(location=2) in vec3 billboardPosition;
+layout(location=3) in vec2 billboardSize;
+layout(location=4) in vec4 uvRect;
+
+#include "frame.glsl"
+
+out vec2 outUV;
+
+void main() {
+    vec3 cameraRight = vec3(viewMatrix[0][0], viewMatrix[1][0], viewMatrix[2][0]);
+    vec3 cameraUp = vec3(viewMatrix[0][1], viewMatrix[1][1], viewMatrix[2][1]);
+
+    vec3 vertexPositionWorldspace =
+        billboardPosition
+        + cameraRight * vertexPosition.x * billboardSize.x
+        + cameraUp * vertexPosition.y * billboardSize.y;
+
+    gl_Position = viewProjection * vec4(vertexPositionWorldspace, 1);
+
+    outUV = uvRect.xy + inUV * uvRect.zw;
+}
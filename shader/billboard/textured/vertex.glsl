@@ -5,9 +5,9 @@ layout(location=1) in vec2 inUV;
 
 uniform vec2 billboardSize;
 uniform vec3 billboardPosition;
+uniform vec4 uvRect; // xy = offset, zw = size
 
-uniform mat4 viewMatrix;
-uniform mat4 viewProjection;
+#include "frame.glsl"
 
 out vec2 outUV;
  
@@ -22,5 +22,5 @@ void main() {
     
     gl_Position = viewProjection * vec4(vertexPositionWorldspace, 1);
 
-    outUV = inUV;
+    outUV = uvRect.xy + inUV * uvRect.zw;
 }
\ No newline at end of file
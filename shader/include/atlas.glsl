@@ -0,0 +1,15 @@
+// Regions of the bound TextureAtlas, see TextureAtlas
+struct TextureRegion {
+    vec4 uvRect; // xy = offset, zw = size
+    vec4 layer;  // x = texture array layer
+};
+
+layout(std140) uniform TextureRegions {
+    TextureRegion textureRegions[256];
+};
+
+// Map uv in 0..1 over the whole image to coordinates in the atlas texture array
+vec3 atlasCoordinates(uint region, vec2 uv) {
+    TextureRegion textureRegion = textureRegions[region];
+    return vec3(textureRegion.uvRect.xy + uv * textureRegion.uvRect.zw, textureRegion.layer.x);
+}
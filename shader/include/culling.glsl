@@ -0,0 +1,11 @@
+// Visibility of a bounding sphere for the current frame, the same test Frustum::intersectsSphere does on the CPU.
+// The planes come normalized from FrameUniforms, instances past the end of the fog are hidden as well.
+#include "frame.glsl"
+
+bool isSphereVisible(vec3 center, float radius) {
+    for (int i=0; i<6; i++) {
+        if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w < -radius) return false;
+    }
+
+    return distance(cameraPosition.xyz, center) - radius < fogParams.y;
+}
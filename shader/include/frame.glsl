@@ -0,0 +1,10 @@
+// Shared by every program, see FrameUniforms
+layout(std140) uniform FrameUniforms {
+    mat4 viewMatrix;
+    mat4 viewProjection;
+    vec4 cameraPosition;
+    vec4 fogColor;
+    vec4 fogParams; // x = fog start, y = fog end
+    vec4 time;      // x = seconds since start, y = frame delta
+    vec4 frustumPlanes[6]; // Of viewProjection, see Frustum
+};
@@ -0,0 +1,69 @@
+#version 430 core
+
+// Cull every instance against the frame and append the visible ones to visibleInstances, counting them in the
+// instance count of an indirect draw command. The positions are decoded from the InstanceFormat selected by
+// a define, the same way the vertex attribute setup of InstanceEncoding does it.
+layout(local_size_x = 256) in;
+
+#include "culling.glsl"
+
+layout(std430, binding = 0) readonly buffer EncodedInstances {
+    uint encodedInstances[];
+};
+
+// Two 16 bit regions per element
+layout(std430, binding = 1) readonly buffer InstanceRegions {
+    uint instanceRegions[];
+};
+
+struct VisibleInstance {
+    vec3 position;
+    uint region;
+};
+
+layout(std430, binding = 2) writeonly buffer VisibleInstances {
+    VisibleInstance visibleInstances[];
+};
+
+// DrawArraysIndirectCommand, instanceCount starts out at 0
+layout(std430, binding = 3) buffer DrawCommand {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint baseInstance;
+};
+
+uniform uint totalInstanceCount;
+uniform float boundingRadius;
+
+uniform vec3 instanceOrigin;
+uniform vec3 instanceScale;
+
+vec3 decodePosition(uint i) {
+#if defined(FORMAT_HALF16)
+    vec3 stored = vec3(unpackHalf2x16(encodedInstances[i*2]), unpackHalf2x16(encodedInstances[i*2 + 1]).x);
+#elif defined(FORMAT_UNORM16)
+    vec3 stored = vec3(unpackUnorm2x16(encodedInstances[i*2]), unpackUnorm2x16(encodedInstances[i*2 + 1]).x);
+#elif defined(FORMAT_PACKED10_10_10_2)
+    uint bits = encodedInstances[i];
+    vec3 stored = vec3(bits & 1023u, (bits >> 10) & 1023u, (bits >> 20) & 1023u) / 1023.0;
+#else
+    vec3 stored = uintBitsToFloat(uvec3(encodedInstances[i*3], encodedInstances[i*3 + 1], encodedInstances[i*3 + 2]));
+#endif
+    return instanceOrigin + stored * instanceScale;
+}
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= totalInstanceCount) return;
+
+    vec3 position = decodePosition(i);
+    if (!isSphereVisible(position, boundingRadius)) return;
+
+    // An odd instance count leaves the last region outside of the bound range
+    uint regionIndex = i / 2;
+    uint region = regionIndex < uint(instanceRegions.length()) ? (instanceRegions[regionIndex] >> ((i & 1u) * 16u)) & 0xFFFFu : 0u;
+
+    uint slot = atomicAdd(instanceCount, 1u);
+    visibleInstances[slot] = VisibleInstance(position, region);
+}
@@ -0,0 +1,24 @@
+#version 410 core
+
+// Only visible instances make it into the feedback buffer
+layout(points) in;
+layout(points, max_vertices = 1) out;
+
+#include "culling.glsl"
+
+in vec3 instancePosition[];
+flat in uint instanceRegion[];
+
+// Captured, interleaved into the same 16 byte records the compute path writes
+out vec3 visiblePosition;
+flat out uint visibleRegion;
+
+uniform float boundingRadius;
+
+void main() {
+    if (!isSphereVisible(instancePosition[0], boundingRadius)) return;
+
+    visiblePosition = instancePosition[0];
+    visibleRegion = instanceRegion[0];
+    EmitVertex();
+}
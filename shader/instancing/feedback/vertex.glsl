@@ -0,0 +1,17 @@
+#version 410 core
+
+// Transform feedback culling for GL 4.1, one point per instance with the rasterizer discarded.
+// Reads the instances through the same attribute setup the instanced draw uses.
+layout(location=2) in vec3 billboardPosition;
+layout(location=3) in uint textureRegion;
+
+out vec3 instancePosition;
+flat out uint instanceRegion;
+
+uniform vec3 instanceOrigin;
+uniform vec3 instanceScale;
+
+void main() {
+    instancePosition = instanceOrigin + billboardPosition * instanceScale;
+    instanceRegion = textureRegion;
+}
@@ -2,27 +2,27 @@
 
 out vec3 color;
 
-uniform sampler2D myTexture;
-in vec2 UV;
+// Every image the instances use, packed by a TextureAtlas
+uniform sampler2DArray myTexture;
+in vec3 atlasUV;
 
 in vec3 finalVertexPos;
 
-uniform vec3 cameraPosition;
-
 vec3 lerp(vec3 a, vec3 b, float t) {
     return a + (b - a) * t;
 }
 
-uniform float fogMin;
-uniform float fogMax;
-
-uniform vec3 fogColor;
+#include "frame.glsl"
 
 void main() {
-    vec3 preColor = texture(myTexture, vec2(UV.x, 1 - UV.y)).rgb;
+    vec3 preColor = texture(myTexture, atlasUV).rgb;
 
-    float fragmentDistance = distance(cameraPosition, finalVertexPos);
+#ifdef FOG
+    float fragmentDistance = distance(cameraPosition.xyz, finalVertexPos);
 
-    float t = (fragmentDistance - fogMin) / (fogMax - fogMin);
-    color = lerp(preColor, fogColor, clamp(t, 0, 1));
+    float t = (fragmentDistance - fogParams.x) / (fogParams.y - fogParams.x);
+    color = lerp(preColor, fogColor.rgb, clamp(t, 0, 1));
+#else
+    color = preColor;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#version 410 core
+
+// The camera facing quad instancing/vertex.glsl builds, for a single point
+layout(points) in;
+layout(triangle_strip, max_vertices = 4) out;
+
+in vec3 pointPosition[];
+flat in uint pointRegion[];
+
+out vec3 atlasUV;
+out vec3 finalVertexPos;
+
+#include "frame.glsl"
+#include "atlas.glsl"
+
+#ifdef BILLBOARD_SIZE
+const vec2 billboardSize = BILLBOARD_SIZE;
+#else
+uniform vec2 billboardSize;
+#endif
+
+// The instanced quad is read from its vertex buffers, its corners double as texture coordinates
+const vec2 corners[4] = vec2[](vec2(0, 0), vec2(1, 0), vec2(0, 1), vec2(1, 1));
+
+void main() {
+    vec3 cameraRight = vec3(viewMatrix[0][0], viewMatrix[1][0], viewMatrix[2][0]);
+    vec3 cameraUp = vec3(viewMatrix[0][1], viewMatrix[1][1], viewMatrix[2][1]);
+
+    for (int i=0; i<4; i++) {
+        vec3 vertexPositionWorldspace =
+            pointPosition[0]
+            + cameraRight * corners[i].x * billboardSize.x
+            + cameraUp * corners[i].y * billboardSize.y;
+
+        gl_Position = viewProjection * vec4(vertexPositionWorldspace, 1);
+
+        finalVertexPos = vertexPositionWorldspace;
+
+#ifdef FLIP_TEXTURE_Y
+        atlasUV = atlasCoordinates(pointRegion[0], vec2(corners[i].x, 1 - corners[i].y));
+#else
+        atlasUV = atlasCoordinates(pointRegion[0], corners[i]);
+#endif
+        EmitVertex();
+    }
+}
@@ -0,0 +1,13 @@
+#version 410 core
+
+// Draws the transform feedback output, one point per visible instance expanded into a quad by the geometry stage
+layout(location=0) in vec3 billboardPosition;
+layout(location=1) in uint textureRegion;
+
+out vec3 pointPosition;
+flat out uint pointRegion;
+
+void main() {
+    pointPosition = billboardPosition;
+    pointRegion = textureRegion;
+}
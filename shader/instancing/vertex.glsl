@@ -6,26 +6,50 @@ layout(location=1) in vec2 textureCoordinates;
 
 // per instance
 layout(location=2) in vec3 billboardPosition;
+layout(location=3) in uint textureRegion;
 
-out vec2 UV;
+out vec3 atlasUV;
 out vec3 finalVertexPos;
 
-uniform mat4 viewMatrix;
-uniform mat4 viewProjection;
+#include "frame.glsl"
+#include "atlas.glsl"
+
+// Constant size when every billboard has the same one
+#ifdef BILLBOARD_SIZE
+const vec2 billboardSize = BILLBOARD_SIZE;
+#else
+uniform vec2 billboardSize;
+#endif
+
+// Instance positions may be stored quantized, see InstanceEncoding.
+// DECODED_POSITIONS reads them as written by the GPU culling instead, already decoded.
+#ifndef DECODED_POSITIONS
+uniform vec3 instanceOrigin;
+uniform vec3 instanceScale;
+#endif
 
 void main() {
     vec3 cameraRight = vec3(viewMatrix[0][0], viewMatrix[1][0], viewMatrix[2][0]);
     vec3 cameraUp = vec3(viewMatrix[0][1], viewMatrix[1][1], viewMatrix[2][1]);
 
-    vec2 billboardSize = vec2(3, 7);
+#ifdef DECODED_POSITIONS
+    vec3 instancePosition = billboardPosition;
+#else
+    vec3 instancePosition = instanceOrigin + billboardPosition * instanceScale;
+#endif
 
     vec3 vertexPositionWorldspace =
-        billboardPosition
+        instancePosition
         + cameraRight * vertexPosition.x * billboardSize.x
         + cameraUp * vertexPosition.y * billboardSize.y;
     
     gl_Position = viewProjection * vec4(vertexPositionWorldspace, 1);
 
     finalVertexPos = vertexPositionWorldspace;
-    UV = textureCoordinates;
-}
\ No newline at end of file
+
+#ifdef FLIP_TEXTURE_Y
+    atlasUV = atlasCoordinates(textureRegion, vec2(textureCoordinates.x, 1 - textureCoordinates.y));
+#else
+    atlasUV = atlasCoordinates(textureRegion, textureCoordinates);
+#endif
+}
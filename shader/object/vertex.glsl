@@ -3,7 +3,7 @@
 layout(location=0) in vec3 vertexPosition;
 layout(location=1) in vec3 colorValue;
 
-uniform mat4 viewProjection;
+#include "frame.glsl"
 
 out vec3 finalColor;
 
@@ -0,0 +1,33 @@
+#include "Benchmark.hpp"
+
+#include <iostream>
+
+BenchmarkRegistration::BenchmarkRegistration(const std::string& name, BenchmarkFunction function) {
+    getBenchmarks()[name] = function;
+}
+
+std::map<std::string, BenchmarkFunction>& getBenchmarks() {
+    // Constructed on first use, registrations run during static initialization
+    static std::map<std::string, BenchmarkFunction> benchmarks;
+    return benchmarks;
+}
+
+bool runBenchmark(const std::string& name) {
+    auto it = getBenchmarks().find(name);
+
+    if (it == getBenchmarks().end()) {
+        std::cout << "There is no benchmark called " << name << '\n';
+        printBenchmarks();
+        return false;
+    }
+
+    it->second();
+    return true;
+}
+
+void printBenchmarks() {
+    std::cout << "Benchmarks:\n";
+    for (auto& [name, function] : getBenchmarks()) {
+        std::cout << "  " << name << '\n';
+    }
+}
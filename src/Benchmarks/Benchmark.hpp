@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <functional>
+
+// Benchmarks run instead of a game when Main is started with --bench <name>.
+// Every benchmark registers itself with a static BenchmarkRegistration in its own source file.
+using BenchmarkFunction = std::function<void()>;
+
+struct BenchmarkRegistration {
+    BenchmarkRegistration(const std::string& name, BenchmarkFunction function);
+};
+
+std::map<std::string, BenchmarkFunction>& getBenchmarks();
+
+// Returns false when there is no benchmark called name
+bool runBenchmark(const std::string& name);
+
+void printBenchmarks();
@@ -0,0 +1,138 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include "Billboards/BillboardStore/BillboardStore.hpp"
+#include "Billboards/BillboardRender/BillboardObject/BillboardObject.hpp"
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Stand-in for TexturedBillboard without the GL objects, the per object work of the draw list
+class BenchmarkBillboard : public BillboardObject {
+public:
+    glm::vec3 position;
+    glm::vec2 size;
+    glm::vec4 uvRect = glm::vec4(0, 0, 1, 1);
+    Texture*  texture;
+
+    void draw() {}
+
+    bool getBatchInstance(BillboardBatchKey& key, BillboardInstance& instance) {
+        key      = { nullptr, texture };
+        instance = { position, size, uvRect };
+        return true;
+    }
+};
+
+static double getMsSince(std::chrono::steady_clock::time_point startTime) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Per frame CPU cost of turning every billboard into batched instance data, the polymorphic draw list
+// of shared_ptrs against the columns of a BillboardStore. Also the cost of churn through handles.
+static void runBillboardStoreBenchmark() {
+    const std::size_t counts[] = { 10000, 100000, 1000000 };
+    const std::uint32_t textureCount = 8;
+    const int frames = 20;
+
+    // Only used as batch keys, never dereferenced
+    std::vector<std::uintptr_t> fakeTextures(textureCount);
+    for (std::uint32_t i=0; i<textureCount; i++) fakeTextures[i] = 16 * (i + 1);
+
+    for (std::size_t count : counts) {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> coordinate(-500.f, 500.f);
+
+        std::vector<std::shared_ptr<BillboardObject>> drawObjects;
+        BillboardStore store;
+        store.reserve(count);
+
+        std::vector<BillboardHandle> handles;
+
+        for (std::size_t i=0; i<count; i++) {
+            const glm::vec3 position(coordinate(random), 0, coordinate(random));
+            const std::uint32_t textureId = random() % textureCount;
+
+            auto billboard = std::make_shared<BenchmarkBillboard>();
+            billboard->position = position;
+            billboard->size     = glm::vec2(3, 7);
+            billboard->texture  = (Texture*)fakeTextures[textureId];
+            drawObjects.push_back(billboard);
+
+            handles.push_back(store.add(position, glm::vec2(3, 7), textureId));
+        }
+
+        // Objects created over time end up all over the heap, iteration order no longer matches memory order
+        std::shuffle(drawObjects.begin(), drawObjects.end(), random);
+
+        std::vector<BillboardInstance> out(count);
+
+        // Draw list, as BillboardRenderer::draw did it: copying every shared_ptr, virtual call, batch map
+        std::map<BillboardBatchKey, std::vector<BillboardInstance>> batches;
+        double drawListMs = 0;
+
+        for (int frame=0; frame<frames; frame++) {
+            const auto startTime = std::chrono::steady_clock::now();
+
+            for (auto& [_, instances] : batches) instances.clear();
+
+            BillboardBatchKey key;
+            BillboardInstance instance;
+
+            for (auto ptr : drawObjects) {
+                if (ptr->getBatchInstance(key, instance)) batches[key].push_back(instance);
+            }
+
+            std::size_t written = 0;
+            for (auto& [_, instances] : batches) {
+                std::copy(instances.begin(), instances.end(), out.begin() + written);
+                written += instances.size();
+            }
+
+            drawListMs += getMsSince(startTime);
+        }
+
+        // Store, counting sort straight into the output
+        std::vector<BillboardBatchRange> ranges;
+        double storeMs = 0;
+
+        for (int frame=0; frame<frames; frame++) {
+            const auto startTime = std::chrono::steady_clock::now();
+            store.writeBatches(out, ranges);
+            storeMs += getMsSince(startTime);
+        }
+
+        // 1% of the billboards replaced per frame
+        const std::size_t churn = count / 100;
+        double churnMs = 0;
+
+        for (int frame=0; frame<frames; frame++) {
+            const auto startTime = std::chrono::steady_clock::now();
+
+            for (std::size_t i=0; i<churn; i++) {
+                BillboardHandle& handle = handles[random() % handles.size()];
+
+                store.remove(handle);
+                handle = store.add(glm::vec3(coordinate(random), 0, coordinate(random)), glm::vec2(3, 7), random() % textureCount);
+            }
+
+            churnMs += getMsSince(startTime);
+        }
+
+        printf(
+            "%8zu billboards: draw list %8.3f ms, store %7.3f ms (%5.1fx), %zu removes + adds %6.3f ms\n",
+            count,
+            drawListMs / frames,
+            storeMs / frames,
+            drawListMs / std::max(storeMs, 1e-9),
+            churn,
+            churnMs / frames
+        );
+    }
+}
+
+static BenchmarkRegistration billboardStoreBenchmark("billboard-store", runBillboardStoreBenchmark);
@@ -0,0 +1,93 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include "Utility/ChunkGrid/ChunkGrid.hpp"
+#include "Utility/FrustumCulling/FrustumCulling.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static double getMsSince(std::chrono::steady_clock::time_point startTime) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Chunk size sweep on the OneMillionBeers field: per frame CPU cost of culling chunk bounds, how many draws the
+// visible chunks take, and how many beers outside the frustum get drawn with them, against culling every beer.
+// Averaged over a camera standing in the middle of the field turning around.
+static void runChunkGridBenchmark() {
+    const std::size_t count = 1000000;
+    const float spacing = 5.f;
+    const float radius = glm::length(glm::vec2(3, 7));
+    const int views = 16;
+    const int runs = 10;
+
+    std::vector<glm::vec3> positions(count);
+    std::vector<float> x(count), y(count, 0.f), z(count);
+    for (std::size_t i=0; i<count; i++) {
+        positions[i] = glm::vec3(i % 500, 0, i / 500) * spacing;
+        x[i] = positions[i].x;
+        z[i] = positions[i].z;
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 4.f / 3.f, .1f, 1000.f);
+    const glm::vec3 eye(1250, 10, 5000);
+
+    std::vector<Frustum> frustums;
+    for (int view=0; view<views; view++) {
+        const float angle = glm::two_pi<float>() * view / views;
+        frustums.push_back(Frustum::fromViewProjection(projection * glm::lookAt(eye, eye + glm::vec3(std::cos(angle), -.05f, std::sin(angle)), glm::vec3(0, 1, 0))));
+    }
+
+    // Every beer on its own
+    const SphereArrays spheres = { x.data(), y.data(), z.data(), nullptr, radius };
+    std::vector<std::uint32_t> visibleIndices(count);
+
+    std::size_t exactVisible = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int run=0; run<runs; run++) {
+        for (const Frustum& frustum : frustums) exactVisible += cullSpheres(frustum, spheres, 0, count, visibleIndices.data());
+    }
+    const double instanceMs = getMsSince(startTime) / (runs * views);
+    exactVisible /= runs * views;
+
+    printf("Per beer:   %7zu spheres, cull %7.3f ms, %7zu beers visible\n", count, instanceMs, exactVisible);
+
+    for (int side : { 4, 8, 16, 32, 64, 128, 256 }) {
+        startTime = std::chrono::steady_clock::now();
+        ChunkGrid grid(positions, side * spacing, radius);
+        const double buildMs = getMsSince(startTime);
+
+        std::vector<InstanceRange> ranges;
+        std::size_t visibleChunks = 0, drawnBeers = 0, draws = 0;
+
+        startTime = std::chrono::steady_clock::now();
+        for (int run=0; run<runs; run++) {
+            for (const Frustum& frustum : frustums) {
+                grid.cull(frustum, ranges);
+
+                visibleChunks += grid.getLastVisibleChunkCount();
+                drawnBeers    += grid.getLastVisibleInstanceCount();
+                draws         += ranges.size();
+            }
+        }
+        const double cullMs = getMsSince(startTime) / (runs * views);
+
+        const double frames = runs * views;
+        printf(
+            "%3dx%-3d:   %7zu chunks,  cull %7.3f ms, %7.0f beers drawn (%5.1f%% outside the frustum), %6.0f chunks in %5.0f draws, built in %6.2f ms\n",
+            side, side,
+            grid.getChunks().size(),
+            cullMs,
+            drawnBeers / frames,
+            100.0 * (drawnBeers / frames - exactVisible) / (drawnBeers / frames),
+            visibleChunks / frames,
+            draws / frames,
+            buildMs
+        );
+    }
+}
+
+static BenchmarkRegistration chunkGridBenchmark("chunk-grid", runChunkGridBenchmark);
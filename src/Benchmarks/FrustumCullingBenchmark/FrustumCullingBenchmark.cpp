@@ -0,0 +1,88 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include "Utility/FrustumCulling/FrustumCulling.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Culling throughput of every path the CPU runs, after checking each one against the scalar reference.
+// A million bounds scattered around a camera, roughly a sixth of them inside its frustum.
+static void runFrustumCullingBenchmark() {
+    const std::size_t count = 1000000;
+    const int runs = 20;
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+    std::uniform_real_distribution<float> extent(.5f, 4.f);
+
+    std::vector<float> x(count), y(count), z(count), radius(count);
+    std::vector<float> minX(count), minY(count), minZ(count), maxX(count), maxY(count), maxZ(count);
+
+    for (std::size_t i=0; i<count; i++) {
+        x[i] = coordinate(random);
+        y[i] = coordinate(random) * .1f;
+        z[i] = coordinate(random);
+        radius[i] = extent(random);
+
+        minX[i] = x[i] - radius[i]; maxX[i] = x[i] + radius[i];
+        minY[i] = y[i] - radius[i]; maxY[i] = y[i] + radius[i];
+        minZ[i] = z[i] - radius[i]; maxZ[i] = z[i] + radius[i];
+    }
+
+    const SphereArrays spheres = { x.data(), y.data(), z.data(), radius.data() };
+    const AABBArrays   boxes   = { minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() };
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 4.f / 3.f, .1f, 1000.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0, 20, 0), glm::vec3(100, 0, 50), glm::vec3(0, 1, 0));
+    const Frustum frustum = Frustum::fromViewProjection(projection * view);
+
+    std::vector<std::uint32_t> reference(count), visible(count);
+
+    // Odd first and count, so the wide paths also run their scalar tails
+    const std::size_t first = 3;
+    const std::size_t testCount = count - 10;
+
+    const std::size_t referenceSpheres = cullSpheres(frustum, spheres, first, testCount, reference.data(), CullingPath::Scalar);
+    printf("%zu of %zu spheres visible\n", referenceSpheres, testCount);
+
+    for (CullingPath path : { CullingPath::Scalar, CullingPath::SSE, CullingPath::AVX2 }) {
+        if (!isCullingPathSupported(path)) {
+            printf("  %-6s not supported by this CPU\n", getCullingPathName(path));
+            continue;
+        }
+
+        bool matches = cullSpheres(frustum, spheres, first, testCount, visible.data(), path) == referenceSpheres;
+        matches = matches && std::equal(reference.begin(), reference.begin() + referenceSpheres, visible.begin());
+
+        auto startTime = std::chrono::steady_clock::now();
+        for (int run=0; run<runs; run++) cullSpheres(frustum, spheres, 0, count, visible.data(), path);
+        const double sphereNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / runs;
+
+        printf("  %-6s spheres %6.3f instances/ns (%6.3f ms)%s\n", getCullingPathName(path), count / sphereNs, sphereNs / 1e6, matches ? "" : "  MISMATCH against scalar!");
+    }
+
+    const std::size_t referenceBoxes = cullAABBs(frustum, boxes, first, testCount, reference.data(), CullingPath::Scalar);
+    printf("%zu of %zu AABBs visible\n", referenceBoxes, testCount);
+
+    for (CullingPath path : { CullingPath::Scalar, CullingPath::SSE, CullingPath::AVX2 }) {
+        if (!isCullingPathSupported(path)) continue;
+
+        bool matches = cullAABBs(frustum, boxes, first, testCount, visible.data(), path) == referenceBoxes;
+        matches = matches && std::equal(reference.begin(), reference.begin() + referenceBoxes, visible.begin());
+
+        auto startTime = std::chrono::steady_clock::now();
+        for (int run=0; run<runs; run++) cullAABBs(frustum, boxes, 0, count, visible.data(), path);
+        const double boxNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / runs;
+
+        printf("  %-6s AABBs   %6.3f instances/ns (%6.3f ms)%s\n", getCullingPathName(path), count / boxNs, boxNs / 1e6, matches ? "" : "  MISMATCH against scalar!");
+    }
+
+    printf("Best path on this CPU: %s\n", getCullingPathName(getBestCullingPath()));
+}
+
+static BenchmarkRegistration frustumCullingBenchmark("frustum-culling", runFrustumCullingBenchmark);
@@ -0,0 +1,196 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "OneMillionBeers/GpuInstanceCuller/GpuInstanceCuller.hpp"
+#include "Utility/GL/FrameUniforms/FrameUniforms.hpp"
+#include "Utility/GL/HeadlessContext/HeadlessContext.hpp"
+#include "Camera/CameraController/CameraController.hpp"
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <tuple>
+#include <cstdio>
+
+static const ShaderProgramDescription instancingShaderDescription = {
+    {
+        { GL_VERTEX_SHADER,   "./shader/instancing/vertex.glsl" },
+        { GL_FRAGMENT_SHADER, "./shader/instancing/fragment.glsl" },
+    },
+    { "FOG", "BILLBOARD_SIZE vec2(3, 7)", "FLIP_TEXTURE_Y" }
+};
+
+static const std::vector<glm::vec2> quadData = { glm::vec2(0, 1), glm::vec2(0, 0), glm::vec2(1, 0), glm::vec2(1, 1) };
+
+// The GPU appends in whatever order its invocations finish, both sides are sorted by this before comparing
+static bool isBefore(const VisibleInstance& a, const VisibleInstance& b) {
+    return std::tie(a.position.x, a.position.z, a.position.y, a.region) < std::tie(b.position.x, b.position.z, b.position.y, b.region);
+}
+
+// Beers only one of the sorted sets holds. The set itself is compared exactly, positions may differ by a rounding
+// error since the GPU is free to fuse the multiply and add of the decode.
+static std::size_t countMismatches(const std::vector<VisibleInstance>& reference, const std::vector<VisibleInstance>& visible) {
+    auto isSame = [](const VisibleInstance& a, const VisibleInstance& b) {
+        return a.region == b.region && glm::all(glm::lessThanEqual(glm::abs(a.position - b.position), glm::vec3(1e-3f)));
+    };
+
+    std::size_t mismatches = 0;
+    std::size_t r = 0, v = 0;
+
+    while (r < reference.size() && v < visible.size()) {
+        if (isSame(reference[r], visible[v])) {
+            r++;
+            v++;
+        } else {
+            mismatches++;
+            if (isBefore(reference[r], visible[v])) r++; else v++;
+        }
+    }
+
+    return mismatches + (reference.size() - r) + (visible.size() - v);
+}
+
+// Every GPU culling path the current context supports on the OneMillionBeers field in every InstanceFormat, against
+// Frustum::intersectsSphere and the fog distance on the CPU, tested on the same decoded positions.
+static void runGpuCulling() {
+    printf("Renderer: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+
+    const std::size_t count = 1000000;
+    const int runs = 20;
+
+    const float boundingRadius = glm::length(glm::vec2(3, 7));
+    const float fogEnd = 1000.f;
+
+    std::vector<glm::vec3> positions(count);
+    std::vector<std::uint16_t> regions(count);
+
+    for (std::size_t i=0; i<count; i++) {
+        positions[i] = glm::vec3(i % 500, 0, i / 500) * 5.f;
+        regions[i]   = i % 16 == 0;
+    }
+
+    ShaderLibrary shaderLibrary;
+
+    // In the middle of the field, so the fog hides a good part of what the frustum holds
+    CameraController cameraController(glm::vec3(1250, 10, 5000));
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 4.f / 3.f, .1f, 2000.f);
+
+    FrameUniforms frameUniforms;
+    frameUniforms.setFog(glm::vec3(1), fogEnd * .5f, fogEnd);
+    frameUniforms.update(cameraController, projection, 0, 0);
+
+    // CPU reference for every format, from the positions as the shaders decode them
+    const Frustum frustum = cameraController.getFrustum(projection);
+
+    std::vector<InstanceEncoding> encodings;
+    std::vector<std::vector<VisibleInstance>> references;
+
+    for (int format=0; format<(int)InstanceFormat::Count; format++) {
+        const InstanceEncoding& encoding = encodings.emplace_back((InstanceFormat)format, positions);
+        std::vector<VisibleInstance>& reference = references.emplace_back();
+
+        for (std::size_t i=0; i<count; i++) {
+            const glm::vec3 position = encoding.decode(i);
+
+            if (frustum.intersectsSphere(position, boundingRadius) && glm::distance(cameraController.getPosition(), position) - boundingRadius < fogEnd) {
+                reference.push_back({ position, regions[i] });
+            }
+        }
+        std::sort(reference.begin(), reference.end(), isBefore);
+
+        printf("%-16s %7zu of %zu beers visible on the CPU\n", InstanceEncoding::getFormatName((InstanceFormat)format), reference.size(), count);
+    }
+
+    Buffer<glm::vec2> quadBuffer;
+    quadBuffer.bufferData(quadData);
+
+    Buffer<std::uint8_t>  instanceBuffer;
+    Buffer<std::uint16_t> regionBuffer;
+    regionBuffer.bufferData(regions);
+
+    for (GpuInstanceCuller::Path path : { GpuInstanceCuller::Path::Compute, GpuInstanceCuller::Path::TransformFeedback }) {
+        if (!GpuInstanceCuller::isPathSupported(path)) {
+            printf("  %-18s not supported by this context\n", GpuInstanceCuller::getPathName(path));
+            continue;
+        }
+
+        GpuInstanceCuller culler(shaderLibrary, instancingShaderDescription, quadBuffer.getBufferId(), quadBuffer.getBufferId(), count, path);
+
+        for (int format=0; format<(int)InstanceFormat::Count; format++) {
+            const InstanceEncoding& encoding = encodings[format];
+            instanceBuffer.bufferData(encoding.data);
+
+            culler.cull(encoding, instanceBuffer.getBufferId(), regionBuffer.getBufferId(), boundingRadius);
+            std::vector<VisibleInstance> visible = culler.readVisibleInstances();
+            std::sort(visible.begin(), visible.end(), isBefore);
+
+            const std::size_t mismatches = countMismatches(references[format], visible);
+
+            char result[96];
+            if (mismatches == 0) {
+                snprintf(result, sizeof(result), "  same beers as the CPU");
+            } else {
+                snprintf(result, sizeof(result), "  MISMATCH, %zu beers differ from the CPU!", mismatches);
+            }
+
+            glFinish();
+            auto startTime = std::chrono::steady_clock::now();
+
+            for (int run=0; run<runs; run++) culler.cull(encoding, instanceBuffer.getBufferId(), regionBuffer.getBufferId(), boundingRadius);
+
+            glFinish();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / runs;
+
+            printf(
+                "  %-18s %-16s %7zu visible, %8.3f ms per cull%s\n",
+                GpuInstanceCuller::getPathName(path),
+                InstanceEncoding::getFormatName((InstanceFormat)format),
+                visible.size(),
+                ms,
+                result
+            );
+        }
+    }
+}
+
+// Runs in a hidden GLFW window, without a display it falls back to a surfaceless EGL context (builds with EGL only),
+// so it also runs headless on Mesa llvmpipe:
+//   LIBGL_ALWAYS_SOFTWARE=1 ./Main --bench gpu-culling
+static void runGpuCullingBenchmark() {
+    if (glfwInit()) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* window = glfwCreateWindow(64, 64, "gpu-culling", nullptr, nullptr);
+
+        if (window != nullptr) {
+            glfwMakeContextCurrent(window);
+
+            if (gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+                runGpuCulling();
+            } else {
+                printf("Failed to load OpenGL/GLAD!\n");
+            }
+
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return;
+        }
+
+        glfwTerminate();
+    }
+
+    printf("No window available, using a headless context\n");
+
+    HeadlessContext context(64, 64);
+    if (!context.isValid()) {
+        printf("Failed to create a headless context!\n");
+        return;
+    }
+
+    runGpuCulling();
+}
+
+static BenchmarkRegistration gpuCullingBenchmark("gpu-culling", runGpuCullingBenchmark);
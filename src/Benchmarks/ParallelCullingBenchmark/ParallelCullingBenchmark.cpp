@@ -0,0 +1,107 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include "Utility/ParallelCuller/ParallelCuller.hpp"
+#include "Utility/ThreadPool/ThreadPool.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+// Visible set build of the OneMillionBeers field (cull, then copy the 8 byte instance and 2 byte region
+// of every visible beer), single threaded and through a ParallelCuller for 1 up to every hardware thread.
+static void runParallelCullingBenchmark() {
+    const std::size_t count = 1000000;
+    const int runs = 20;
+
+    // Same layout as the field, 500 beers a row, 5 units apart
+    std::vector<float> x(count), y(count, 0.f), z(count);
+    for (std::size_t i=0; i<count; i++) {
+        x[i] = (i % 500) * 5.f;
+        z[i] = (i / 500) * 5.f;
+    }
+
+    // Same bounding sphere as the field, as wide as the billboard diagonal
+    const SphereArrays spheres = { x.data(), y.data(), z.data(), nullptr, glm::length(glm::vec2(3, 7)) };
+
+    std::vector<std::uint64_t> instances(count);
+    std::vector<std::uint16_t> regions(count);
+    for (std::size_t i=0; i<count; i++) {
+        instances[i] = i * 0x9E3779B97F4A7C15ull;
+        regions[i]   = i % 16 == 0;
+    }
+
+    std::vector<std::uint64_t> visibleInstances(count);
+    std::vector<std::uint16_t> visibleRegions(count);
+
+    // Standing in the field looking along it, with the far plane of the fog
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 4.f / 3.f, .1f, 1000.f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(1250, 10, 2500), glm::vec3(1250, 0, 3500), glm::vec3(0, 1, 0));
+    const Frustum frustum = Frustum::fromViewProjection(projection * view);
+
+    auto gather = [&](std::span<const std::uint32_t> visibleIndices, std::size_t outputOffset) {
+        for (std::size_t i=0; i<visibleIndices.size(); i++) {
+            visibleInstances[outputOffset + i] = instances[visibleIndices[i]];
+            visibleRegions[outputOffset + i]   = regions[visibleIndices[i]];
+        }
+    };
+
+    // Single threaded reference
+    std::vector<std::uint32_t> visibleIndices(count);
+    std::size_t visibleCount = 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (int run=0; run<runs; run++) {
+        visibleCount = cullSpheres(frustum, spheres, 0, count, visibleIndices.data());
+        gather(std::span<const std::uint32_t>(visibleIndices.data(), visibleCount), 0);
+    }
+    const double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / runs;
+
+    const std::vector<std::uint64_t> referenceInstances(visibleInstances.begin(), visibleInstances.begin() + visibleCount);
+    const std::vector<std::uint16_t> referenceRegions(visibleRegions.begin(), visibleRegions.begin() + visibleCount);
+
+    printf("%zu of %zu beers visible, %s kernels\n", visibleCount, count, getCullingPathName(getBestCullingPath()));
+    printf("  single threaded     %7.3f ms\n", serialMs);
+
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t threads = 1; threads < std::thread::hardware_concurrency(); threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(std::max(std::thread::hardware_concurrency(), 1u));
+
+    for (std::size_t threadCount : threadCounts) {
+        ThreadPool threadPool(threadCount);
+        ParallelCuller culler(threadPool);
+
+        double cullMs = 0, compactMs = 0;
+        std::size_t parallelVisibleCount = 0;
+
+        startTime = std::chrono::steady_clock::now();
+        for (int run=0; run<runs; run++) {
+            parallelVisibleCount = culler.cull(frustum, spheres, count, gather);
+
+            cullMs    += culler.getLastStats().cullMs;
+            compactMs += culler.getLastStats().compactMs;
+        }
+        const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / runs;
+
+        const bool matches =
+            parallelVisibleCount == visibleCount &&
+            std::equal(referenceInstances.begin(), referenceInstances.end(), visibleInstances.begin()) &&
+            std::equal(referenceRegions.begin(), referenceRegions.end(), visibleRegions.begin());
+
+        printf(
+            "  %2zu threads          %7.3f ms (cull %6.3f, scan + compact %6.3f), %4.2fx%s\n",
+            threadCount,
+            totalMs,
+            cullMs / runs,
+            compactMs / runs,
+            serialMs / totalMs,
+            matches ? "" : "  MISMATCH against single threaded!"
+        );
+    }
+}
+
+static BenchmarkRegistration parallelCullingBenchmark("parallel-culling", runParallelCullingBenchmark);
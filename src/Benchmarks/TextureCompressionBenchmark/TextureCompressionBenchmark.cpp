@@ -0,0 +1,107 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include "Utility/BlockCompression/BlockCompression.hpp"
+#include "Utility/TextureCache/TextureCache.hpp"
+#include "Utility/Image/Image.hpp"
+
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+static double getSecondsSince(std::chrono::steady_clock::time_point startTime) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Peak signal to noise ratio over the channels that matter for the format, higher is better
+static double getPSNR(const Image& a, const Image& b, int channels) {
+    double squaredError = 0;
+
+    for (std::size_t i=0; i<a.pixels.size(); i++) {
+        if ((int)(i % 4) >= channels) continue;
+
+        const double delta = (double)a.pixels[i] - b.pixels[i];
+        squaredError += delta * delta;
+    }
+
+    const double meanSquaredError = squaredError / (a.width * a.height * channels);
+    return meanSquaredError == 0 ? INFINITY : 10 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+// Encoder speed and quality per format, then startup cost of decoding the source versus reading the cache.
+// Doubles as a round trip check of the encoders against the CPU decoders used as driver fallback.
+static void runTextureCompressionBenchmark() {
+    const std::vector<std::string> paths = { "onebeerplease.jpg", "kanye.png" };
+    const BlockFormat formats[] = { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7 };
+
+    for (const std::string& path : paths) {
+        std::optional<Image> image = Image::loadFromFile(path);
+        if (!image) {
+            std::cout << "Run from the repository root\n";
+            return;
+        }
+
+        printf("%s, %zux%zu\n", path.c_str(), image->width, image->height);
+
+        for (BlockFormat format : formats) {
+            const auto startTime = std::chrono::steady_clock::now();
+            std::vector<std::uint8_t> blocks = compressImage(*image, format);
+            const double seconds = getSecondsSince(startTime);
+
+            Image decoded = decompressImage(blocks.data(), image->width, image->height, format);
+
+            printf(
+                "  %s: %6.2f MTexels/s, %6.1f KB (%.0f:1), PSNR %5.2f dB\n",
+                getBlockFormatName(format),
+                image->width * image->height / seconds / 1e6,
+                blocks.size() / 1024.0,
+                (double)image->getByteSize() / blocks.size(),
+                getPSNR(*image, decoded, format == BlockFormat::BC1 ? 3 : 4)
+            );
+        }
+    }
+
+    // Cold bakes and writes the cache file, warm maps it
+    const std::string originalCacheDirectory = TextureCache::cacheDirectory;
+    TextureCache::cacheDirectory = (std::filesystem::temp_directory_path() / "texturecache-benchmark").string();
+
+    std::error_code error;
+    std::filesystem::remove_all(TextureCache::cacheDirectory, error);
+
+    printf("Startup per image with the full mip chain\n");
+
+    for (const std::string& path : paths) {
+        auto startTime = std::chrono::steady_clock::now();
+        std::optional<Image> decoded = Image::loadFromFile(path);
+        const double decodeSeconds = getSecondsSince(startTime);
+
+        startTime = std::chrono::steady_clock::now();
+        buildMipChain(std::move(*decoded));
+        const double mipSeconds = getSecondsSince(startTime);
+
+        startTime = std::chrono::steady_clock::now();
+        TextureCache::load(path, BlockFormat::BC7);
+        const double coldSeconds = getSecondsSince(startTime);
+
+        startTime = std::chrono::steady_clock::now();
+        std::optional<CompressedImage> cached = TextureCache::load(path, BlockFormat::BC7);
+        const double warmSeconds = getSecondsSince(startTime);
+
+        printf(
+            "  %-18s decode + mips %7.2f ms, BC7 bake %8.2f ms, BC7 from cache %6.3f ms (%s)\n",
+            path.c_str(),
+            (decodeSeconds + mipSeconds) * 1e3,
+            coldSeconds * 1e3,
+            warmSeconds * 1e3,
+            cached && cached->mappedFile ? "mapped" : "cache miss!"
+        );
+    }
+
+    std::filesystem::remove_all(TextureCache::cacheDirectory, error);
+    TextureCache::cacheDirectory = originalCacheDirectory;
+}
+
+static BenchmarkRegistration textureCompressionBenchmark("texture-compression", runTextureCompressionBenchmark);
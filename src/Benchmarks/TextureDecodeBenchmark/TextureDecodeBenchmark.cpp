@@ -0,0 +1,80 @@
+#include "Benchmarks/Benchmark.hpp"
+
+#include "Utility/Image/Image.hpp"
+#include "Utility/ThreadPool/ThreadPool.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <future>
+#include <chrono>
+#include <cstdio>
+
+// Images per second the texture loader's workers get through, for 1 up to every hardware thread.
+// The files are read into memory first so only decoding (and mip building) is measured.
+static void runTextureDecodeBenchmark() {
+    const std::vector<std::string> paths = { "onebeerplease.jpg", "kanye.png" };
+    const int imagesPerRun = 64;
+
+    std::vector<std::vector<char>> files;
+    for (const std::string& path : paths) {
+        std::ifstream file(path, std::ios::binary);
+        files.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        if (files.back().empty()) {
+            std::cout << "Failed to read " << path << ", run from the repository root\n";
+            return;
+        }
+    }
+
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t count = 1; count < std::thread::hardware_concurrency(); count *= 2) threadCounts.push_back(count);
+    threadCounts.push_back(std::max(std::thread::hardware_concurrency(), 1u));
+
+    for (bool buildMipmaps : { false, true }) {
+        printf("%s, %d images per run\n", buildMipmaps ? "Decode + mip chain on the worker" : "Decode to RGBA8", imagesPerRun);
+
+        double singleThreadRate = 0;
+
+        for (std::size_t threadCount : threadCounts) {
+            ThreadPool threadPool(threadCount);
+
+            const auto startTime = std::chrono::steady_clock::now();
+
+            std::vector<std::future<std::size_t>> decodes;
+            for (int i=0; i<imagesPerRun; i++) {
+                const std::vector<char>& file = files[i % files.size()];
+
+                decodes.push_back(threadPool.submit([&file, buildMipmaps]() -> std::size_t {
+                    std::optional<Image> image = Image::loadFromMemory(file.data(), file.size());
+                    if (!image) return 0;
+
+                    const std::size_t texels = image->width * image->height;
+                    if (buildMipmaps) buildMipChain(std::move(*image));
+
+                    return texels;
+                }));
+            }
+
+            std::size_t texels = 0;
+            for (auto& decode : decodes) texels += decode.get();
+
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            const double rate = imagesPerRun / seconds;
+
+            if (singleThreadRate == 0) singleThreadRate = rate;
+
+            printf(
+                "  %2zu threads: %8.1f images/s, %7.1f MTexels/s, %4.2fx\n",
+                threadCount,
+                rate,
+                texels / seconds / 1e6,
+                rate / singleThreadRate
+            );
+        }
+    }
+}
+
+static BenchmarkRegistration textureDecodeBenchmark("texture-decode", runTextureDecodeBenchmark);
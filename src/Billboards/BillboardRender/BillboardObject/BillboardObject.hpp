@@ -2,8 +2,32 @@
 
 #include <glm/glm.hpp>
 
+#include <compare>
+
+class ShaderProgram;
+class Texture;
+
+// One billboard in an instanced batch, the per instance vertex data of BillboardRenderer
+struct BillboardInstance {
+    glm::vec3 position;
+    glm::vec2 size;
+    glm::vec4 uvRect; // xy = offset, zw = size, in texture coordinates
+};
+
+// Billboards with the same key are drawn with a single instanced call.
+// The program has to take the attributes of shader/billboard/instanced/vertex.glsl.
+struct BillboardBatchKey {
+    ShaderProgram* shader;
+    Texture*       texture;
+
+    auto operator<=>(const BillboardBatchKey&) const = default;
+};
 
 class BillboardObject {
 public:
-    virtual void draw(glm::mat4 viewMatrix, glm::mat4 viewProjection) = 0;  
-};
\ No newline at end of file
+    // Camera state comes from the FrameUniforms block
+    virtual void draw() = 0;  
+
+    // Fill key and instance and return true to be drawn as part of a batch instead of through draw()
+    virtual bool getBatchInstance(BillboardBatchKey&, BillboardInstance&) { return false; }
+};
@@ -1,15 +1,154 @@
 #include "BillboardRenderer.hpp"
+#include "ShaderReflection.hpp"
 
-BillboardRenderer::BillboardRenderer() {
+#include "Utility/GL/Texture/Texture.hpp"
 
+#include <algorithm>
+#include <bit>
+
+const ShaderProgramDescription BillboardRenderer::instancedShaderDescription = {
+    {
+        { GL_VERTEX_SHADER,   "./shader/billboard/instanced/vertex.glsl" },
+        { GL_FRAGMENT_SHADER, "./shader/billboard/instanced/fragment.glsl" },
+    },
+    {}
+};
+
+const std::vector<glm::vec2> BillboardRenderer::quadVertexData = {
+    glm::vec2(-0.5f, -0.5f),
+    glm::vec2(-0.5f, 0.5f),
+    glm::vec2(0.5f, 0.5f),
+    glm::vec2(0.5f, -0.5f),
+};
+
+const std::vector<glm::vec2> BillboardRenderer::quadUVData = {
+    glm::vec2(0, 1),
+    glm::vec2(0, 0),
+    glm::vec2(1, 0),
+    glm::vec2(1, 1),
+};
+
+using BillboardInstanceLayout = VertexLayout<
+    InstanceAttribute<ShaderReflection::billboard_instanced::attribute::billboardPosition, glm::vec3>,
+    InstanceAttribute<ShaderReflection::billboard_instanced::attribute::billboardSize, glm::vec2>,
+    InstanceAttribute<ShaderReflection::billboard_instanced::attribute::uvRect, glm::vec4>
+>;
+
+static_assert(BillboardInstanceLayout::stride == sizeof(BillboardInstance), "BillboardInstance has to be tightly packed");
+
+BillboardRenderer::BillboardRenderer(ShaderLibrary& _shaderLibrary): shaderLibrary(_shaderLibrary) {
+    bufferArena = std::make_shared<BufferArena>(1024 * 1024);
+
+    instancedShader = shaderLibrary.request(instancedShaderDescription);
+
+    quadVertexBuffer = bufferArena->createStatic<glm::vec2>(quadVertexData);
+    quadUVBuffer     = bufferArena->createStatic<glm::vec2>(quadUVData);
+
+    batchVertexArray.attachBuffer<VertexLayout<Attribute<ShaderReflection::billboard_instanced::attribute::vertexPosition, glm::vec2>>>(quadVertexBuffer->getBufferId(), quadVertexBuffer->getOffset());
+    batchVertexArray.attachBuffer<VertexLayout<Attribute<ShaderReflection::billboard_instanced::attribute::inUV, glm::vec2>>>(quadUVBuffer->getBufferId(), quadUVBuffer->getOffset());
+
+    instanceStream = std::make_unique<StreamBuffer<BillboardInstance>>(1024);
 }
 
 BillboardRenderer::~BillboardRenderer() {
 
 }
 
-void BillboardRenderer::draw(glm::mat4 viewMatrix, glm::mat4 viewProjection) {
-    for(auto ptr : drawObjects) {
-        ptr->draw(viewMatrix, viewProjection);
+void BillboardRenderer::draw() {
+    lastDrawCallCount = 0;
+
+    for (auto& [_, instances] : batches) instances.clear();
+
+    BillboardBatchKey key;
+    BillboardInstance instance;
+
+    for(auto& ptr : drawObjects) {
+        if (useBatching && ptr->getBatchInstance(key, instance)) {
+            batches[key].push_back(instance);
+            continue;
+        }
+
+        ptr->draw();
+        lastDrawCallCount++;
+    }
+
+    drawBatches();
+}
+
+void BillboardRenderer::drawBatches() {
+    std::size_t instanceCount = 0;
+    for (auto& [_, instances] : batches) instanceCount += instances.size();
+
+    // Hidden billboards of the store are left out, so this may be a few too many
+    instanceCount += store.getCount();
+
+    if (instanceCount == 0) return;
+
+    // Immutable storage, outgrowing it means a new stream. GL keeps the old one alive until the GPU is done with it.
+    if (instanceCount > instanceStream->capacity()) {
+        instanceStream = std::make_unique<StreamBuffer<BillboardInstance>>(std::bit_ceil(instanceCount));
+    }
+
+    // Every batch back to back in this frame's region
+    std::span<BillboardInstance> frameInstances = instanceStream->beginFrame();
+    std::size_t written = 0;
+
+    for (auto& [_, instances] : batches) {
+        std::copy(instances.begin(), instances.end(), frameInstances.begin() + written);
+        written += instances.size();
+    }
+
+    const std::size_t storeFirstInstance = written;
+    store.writeBatches(frameInstances.subspan(written), storeRanges);
+
+    instanceStream->endWrites();
+
+    glActiveTexture(GL_TEXTURE0);
+
+    auto drawBatch = [&](ShaderProgram& shader, Texture& texture, std::size_t first, std::size_t count) {
+        // Point the instance attributes at the batch, works without base instance support (GL 4.2)
+        const GLintptr batchOffset = instanceStream->getFrameOffset() + sizeof(BillboardInstance) * first;
+        batchVertexArray.attachBuffer<BillboardInstanceLayout>(instanceStream->getBufferId(), batchOffset);
+
+        shader.use();
+        glBindTexture(GL_TEXTURE_2D, texture.getTextureId());
+
+        glDrawArraysInstanced(GL_QUADS, 0, 4, count);
+        lastDrawCallCount++;
+    };
+
+    std::size_t firstInstance = 0;
+
+    for (auto& [key, instances] : batches) {
+        if (!instances.empty()) drawBatch(*key.shader, *key.texture, firstInstance, instances.size());
+        firstInstance += instances.size();
     }
-}
\ No newline at end of file
+
+    for (std::uint32_t textureId=0; textureId<storeRanges.size(); textureId++) {
+        const BillboardBatchRange& range = storeRanges[textureId];
+        if (range.count == 0 || textureId >= storeTextures.size() || storeTextures[textureId] == nullptr) continue;
+
+        drawBatch(*instancedShader, *storeTextures[textureId], storeFirstInstance + range.first, range.count);
+    }
+
+    instanceStream->endFrame();
+
+    // Batches of materials that went away
+    std::erase_if(batches, [](auto& batch) { return batch.second.empty(); });
+}
+
+std::uint32_t BillboardRenderer::getTextureId(const std::shared_ptr<Texture>& texture) {
+    auto it = std::find(storeTextures.begin(), storeTextures.end(), texture);
+    if (it != storeTextures.end()) return it - storeTextures.begin();
+
+    storeTextures.push_back(texture);
+    return storeTextures.size() - 1;
+}
+
+const std::shared_ptr<Texture>& BillboardRenderer::getTexture(std::uint32_t textureId) const {
+    return storeTextures[textureId];
+}
+
+std::size_t BillboardRenderer::getLastDrawCallCount() const {
+    return lastDrawCallCount;
+}
@@ -1,22 +1,73 @@
 #pragma once
 
-#include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
+#include "Utility/GL/ShaderLibrary/ShaderLibrary.hpp"
+#include "Utility/GL/BufferArena/BufferArena.hpp"
+#include "Utility/GL/StreamBuffer/StreamBuffer.hpp"
+#include "Utility/GL/VertexArray/VertexArray.hpp"
 #include "BillboardObject/BillboardObject.hpp"
+#include "Billboards/BillboardStore/BillboardStore.hpp"
 
-#include <string>
 #include <map>
+#include <vector>
 #include <memory>
 
+// Draws the billboards of the draw list. Every frame billboards that support it are collected into
+// one instance stream per (shader, texture) and each batch is a single instanced draw, so the number
+// of draw calls follows the number of materials instead of the number of billboards.
+//
+// Plain textured billboards are best kept in store, which skips the per object work altogether.
+// Objects in drawObjects are for billboards with their own behaviour.
 class BillboardRenderer {
+private:
+    std::shared_ptr<ArenaBuffer<glm::vec2>> quadVertexBuffer;
+    std::shared_ptr<ArenaBuffer<glm::vec2>> quadUVBuffer;
+
+    VertexArray batchVertexArray;
+    std::unique_ptr<StreamBuffer<BillboardInstance>> instanceStream;
+
+    // Cleared every frame, the vectors keep their capacity
+    std::map<BillboardBatchKey, std::vector<BillboardInstance>> batches;
+    std::vector<BillboardBatchRange> storeRanges;
+
+    // Texture id in store -> texture
+    std::vector<std::shared_ptr<Texture>> storeTextures;
+
+    std::size_t lastDrawCallCount = 0;
+
+    void drawBatches();
 public:
-    // Keep track of loaded shaders for billboards
-    std::map<std::string, std::shared_ptr<ShaderProgram>> loadedShaders;
+    static const ShaderProgramDescription instancedShaderDescription;
+
+    // Unit quad shared by every billboard type, drawn as GL_QUADS
+    static const std::vector<glm::vec2> quadVertexData;
+    static const std::vector<glm::vec2> quadUVData;
+
+    // Billboards get their shader programs from here
+    ShaderLibrary& shaderLibrary;
+
+    // Shared vertex storage for billboards, identical geometry is only stored once
+    std::shared_ptr<BufferArena> bufferArena;
+
+    // Program for batches of textured billboards
+    std::shared_ptr<ShaderProgram> instancedShader;
 
     // Draw list
     std::vector<std::shared_ptr<BillboardObject>> drawObjects;
 
-    BillboardRenderer();
+    // Billboards drawn with instancedShader, their texture ids come from getTextureId()
+    BillboardStore store;
+
+    // Off draws every billboard on its own, for comparison
+    bool useBatching = true;
+
+    BillboardRenderer(ShaderLibrary& shaderLibrary);
     ~BillboardRenderer();
 
-    void draw(glm::mat4 viewMatrix, glm::mat4 viewProjection);
-};
\ No newline at end of file
+    void draw();
+
+    // Id of texture for billboards in store, the same texture always gets the same id
+    std::uint32_t getTextureId(const std::shared_ptr<Texture>& texture);
+    const std::shared_ptr<Texture>& getTexture(std::uint32_t textureId) const;
+
+    std::size_t getLastDrawCallCount() const;
+};
@@ -0,0 +1,186 @@
+#include "BillboardStore.hpp"
+
+#include <algorithm>
+
+std::uint32_t BillboardStore::getIndex(BillboardHandle handle) const {
+    if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation) return UINT32_MAX;
+    return slots[handle.slot].index;
+}
+
+BillboardHandle BillboardStore::add(glm::vec3 position, glm::vec2 size, std::uint32_t textureId, glm::vec4 uvRect) {
+    const std::uint32_t index = positions.size();
+
+    std::uint32_t slot = firstFreeSlot;
+    if (slot != UINT32_MAX) {
+        firstFreeSlot = slots[slot].index;
+        slots[slot].index = index;
+    } else {
+        slot = slots.size();
+        slots.push_back({ index, 1 });
+    }
+
+    positions.push_back(position);
+    sizes.push_back(size);
+    uvRects.push_back(uvRect);
+    textureIds.push_back(textureId);
+    flags.push_back(BillboardVisible);
+    slotOfIndex.push_back(slot);
+
+    textureIdLimit = std::max(textureIdLimit, textureId + 1);
+
+    return { slot, slots[slot].generation };
+}
+
+void BillboardStore::remove(BillboardHandle handle) {
+    const std::uint32_t index = getIndex(handle);
+    if (index == UINT32_MAX) return;
+
+    // Move the last billboard into the hole
+    const std::uint32_t last = positions.size() - 1;
+
+    if (index != last) {
+        positions[index]   = positions[last];
+        sizes[index]       = sizes[last];
+        uvRects[index]     = uvRects[last];
+        textureIds[index]  = textureIds[last];
+        flags[index]       = flags[last];
+        slotOfIndex[index] = slotOfIndex[last];
+
+        slots[slotOfIndex[index]].index = index;
+    }
+
+    positions.pop_back();
+    sizes.pop_back();
+    uvRects.pop_back();
+    textureIds.pop_back();
+    flags.pop_back();
+    slotOfIndex.pop_back();
+
+    Slot& slot = slots[handle.slot];
+    slot.generation++;
+    slot.index    = firstFreeSlot;
+    firstFreeSlot = handle.slot;
+}
+
+bool BillboardStore::contains(BillboardHandle handle) const {
+    return getIndex(handle) != UINT32_MAX;
+}
+
+void BillboardStore::clear() {
+    // Every slot goes back to the free list with a new generation, so no old handle matches again
+    for (std::uint32_t index=0; index<slotOfIndex.size(); index++) {
+        Slot& slot = slots[slotOfIndex[index]];
+        slot.generation++;
+        slot.index    = firstFreeSlot;
+        firstFreeSlot = slotOfIndex[index];
+    }
+
+    positions.clear();
+    sizes.clear();
+    uvRects.clear();
+    textureIds.clear();
+    flags.clear();
+    slotOfIndex.clear();
+
+    textureIdLimit = 0;
+}
+
+void BillboardStore::reserve(std::size_t count) {
+    positions.reserve(count);
+    sizes.reserve(count);
+    uvRects.reserve(count);
+    textureIds.reserve(count);
+    flags.reserve(count);
+    slotOfIndex.reserve(count);
+    slots.reserve(count);
+}
+
+void BillboardStore::setPosition(BillboardHandle handle, glm::vec3 position) {
+    const std::uint32_t index = getIndex(handle);
+    if (index != UINT32_MAX) positions[index] = position;
+}
+
+void BillboardStore::setSize(BillboardHandle handle, glm::vec2 size) {
+    const std::uint32_t index = getIndex(handle);
+    if (index != UINT32_MAX) sizes[index] = size;
+}
+
+void BillboardStore::setUVRect(BillboardHandle handle, glm::vec4 uvRect) {
+    const std::uint32_t index = getIndex(handle);
+    if (index != UINT32_MAX) uvRects[index] = uvRect;
+}
+
+void BillboardStore::setTextureId(BillboardHandle handle, std::uint32_t textureId) {
+    const std::uint32_t index = getIndex(handle);
+    if (index == UINT32_MAX) return;
+
+    textureIds[index] = textureId;
+    textureIdLimit = std::max(textureIdLimit, textureId + 1);
+}
+
+void BillboardStore::setVisible(BillboardHandle handle, bool visible) {
+    const std::uint32_t index = getIndex(handle);
+    if (index == UINT32_MAX) return;
+
+    if (visible) flags[index] |= BillboardVisible;
+    else         flags[index] &= ~BillboardVisible;
+}
+
+glm::vec3 BillboardStore::getPosition(BillboardHandle handle) const {
+    const std::uint32_t index = getIndex(handle);
+    return index != UINT32_MAX ? positions[index] : glm::vec3(0);
+}
+
+std::span<glm::vec3> BillboardStore::getPositions() {
+    return positions;
+}
+
+std::span<const glm::vec3> BillboardStore::getPositions() const {
+    return positions;
+}
+
+std::span<const glm::vec2> BillboardStore::getSizes() const {
+    return sizes;
+}
+
+std::span<const std::uint32_t> BillboardStore::getTextureIds() const {
+    return textureIds;
+}
+
+std::span<std::uint8_t> BillboardStore::getFlags() {
+    return flags;
+}
+
+std::size_t BillboardStore::getCount() const {
+    return positions.size();
+}
+
+std::uint32_t BillboardStore::getTextureIdLimit() const {
+    return textureIdLimit;
+}
+
+std::size_t BillboardStore::writeBatches(std::span<BillboardInstance> out, std::vector<BillboardBatchRange>& ranges) const {
+    ranges.assign(textureIdLimit, { 0, 0 });
+
+    for (std::size_t i=0; i<textureIds.size(); i++) {
+        if (flags[i] & BillboardVisible) ranges[textureIds[i]].count++;
+    }
+
+    std::uint32_t first = 0;
+    for (BillboardBatchRange& range : ranges) {
+        range.first = first;
+        first += range.count;
+    }
+
+    // Scatter, reusing count as the write cursor of each range
+    for (BillboardBatchRange& range : ranges) range.count = 0;
+
+    for (std::size_t i=0; i<textureIds.size(); i++) {
+        if (!(flags[i] & BillboardVisible)) continue;
+
+        BillboardBatchRange& range = ranges[textureIds[i]];
+        out[range.first + range.count++] = { positions[i], sizes[i], uvRects[i] };
+    }
+
+    return first;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Billboards/BillboardRender/BillboardObject/BillboardObject.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// Refers to a billboard in a BillboardStore. Stays valid while the billboard exists, no matter how
+// often others are added or removed, and goes stale for good once it is removed.
+struct BillboardHandle {
+    std::uint32_t slot = UINT32_MAX;
+    std::uint32_t generation = 0;
+};
+
+enum BillboardFlags : std::uint8_t {
+    BillboardVisible = 1 << 0,
+};
+
+// Where the instances of one texture ended up in writeBatches' output
+struct BillboardBatchRange {
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+// Plain billboards kept as columns (structure of arrays) instead of one heap object each.
+//
+// Column i of every array belongs to the same billboard and the columns stay dense, so passes over
+// all billboards (culling, sorting, writing instance data) stream through contiguous memory without
+// pointer chasing, refcounting or virtual calls. Removing swaps the last billboard into the hole.
+// Handles go through a slot table holding the current column index and a generation counter.
+//
+// Texture ids are small integers chosen by the owner of the store, BillboardRenderer maps them to textures.
+class BillboardStore {
+private:
+    struct Slot {
+        std::uint32_t index;      // Column index while alive, next free slot otherwise
+        std::uint32_t generation; // Bumped on remove, so old handles stop matching
+    };
+
+    std::vector<glm::vec3>     positions;
+    std::vector<glm::vec2>     sizes;
+    std::vector<glm::vec4>     uvRects;
+    std::vector<std::uint32_t> textureIds;
+    std::vector<std::uint8_t>  flags;
+
+    // Column index -> slot, to fix the slot of the billboard moved by a remove
+    std::vector<std::uint32_t> slotOfIndex;
+
+    std::vector<Slot> slots;
+    std::uint32_t     firstFreeSlot = UINT32_MAX;
+
+    std::uint32_t textureIdLimit = 0;
+
+    std::uint32_t getIndex(BillboardHandle handle) const;
+public:
+    BillboardHandle add(glm::vec3 position, glm::vec2 size, std::uint32_t textureId, glm::vec4 uvRect = glm::vec4(0, 0, 1, 1));
+
+    // Stale handles are ignored
+    void remove(BillboardHandle handle);
+    bool contains(BillboardHandle handle) const;
+
+    void clear();
+    void reserve(std::size_t count);
+
+    void setPosition(BillboardHandle handle, glm::vec3 position);
+    void setSize(BillboardHandle handle, glm::vec2 size);
+    void setUVRect(BillboardHandle handle, glm::vec4 uvRect);
+    void setTextureId(BillboardHandle handle, std::uint32_t textureId);
+    void setVisible(BillboardHandle handle, bool visible);
+
+    glm::vec3 getPosition(BillboardHandle handle) const;
+
+    // Columns in no particular order, for passes over every billboard
+    std::span<glm::vec3>           getPositions();
+    std::span<const glm::vec3>     getPositions() const;
+    std::span<const glm::vec2>     getSizes() const;
+    std::span<const std::uint32_t> getTextureIds() const;
+    std::span<std::uint8_t>        getFlags();
+
+    std::size_t getCount() const;
+
+    // One more than the largest texture id in use
+    std::uint32_t getTextureIdLimit() const;
+
+    // Counting sort of the visible billboards by texture id into out, which needs room for getCount() instances.
+    // ranges gets one entry per texture id. Returns the number of instances written.
+    std::size_t writeBatches(std::span<BillboardInstance> out, std::vector<BillboardBatchRange>& ranges) const;
+};
@@ -4,33 +4,42 @@
 #include "Billboards/BillboardRender/BillboardRenderer.hpp"
 
 #include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
-#include "Utility/GL/Buffer/Buffer.hpp"
+#include "Utility/GL/ShaderLibrary/ShaderLibrary.hpp"
+#include "Utility/GL/BufferArena/BufferArena.hpp"
 #include "Utility/GL/Texture/Texture.hpp"
+#include "Utility/GL/VertexArray/VertexArray.hpp"
 
 #include <memory>
 
 class TexturedBillboard : public BillboardObject {
 private:
-    Buffer<glm::vec2> billboardVertexBuffer;
-    Buffer<glm::vec2> billboardUVBuffer;
+    // Shared between every billboard through the renderer's buffer arena
+    std::shared_ptr<ArenaBuffer<glm::vec2>> billboardVertexBuffer;
+    std::shared_ptr<ArenaBuffer<glm::vec2>> billboardUVBuffer;
 
-    std::shared_ptr<ShaderProgram> shader;
-    GLuint billboardSizeUniform;
-    GLuint billboardPositionUniform;
-
-    GLuint billboardViewProjectionUniform;
-    GLuint billboardViewMatrixUniform;
+    VertexArray vertexArray;
 
-    GLuint billboardTextureUniform;
+    std::shared_ptr<ShaderProgram> shader;
+    std::shared_ptr<ShaderProgram> instancedShader;
+    UniformHandle billboardSizeUniform;
+    UniformHandle billboardPositionUniform;
+    UniformHandle uvRectUniform;
 
-    static std::shared_ptr<ShaderProgram> loadShader();
+    UniformHandle billboardTextureUniform;
 public:
+    static const ShaderProgramDescription shaderDescription;
+
     glm::vec3 position;
     glm::vec2 size;
     std::shared_ptr<Texture>           billboardTexture;
 
+    // Part of billboardTexture to show, xy = offset, zw = size. Sprite sheets put several
+    // images in one texture so their billboards share a batch.
+    glm::vec4 uvRect = glm::vec4(0, 0, 1, 1);
+
     TexturedBillboard(BillboardRenderer& renderer);
     ~TexturedBillboard();
 
-    void draw(glm::mat4 viewMatrix, glm::mat4 viewProjection);
+    void draw();
+    bool getBatchInstance(BillboardBatchKey& key, BillboardInstance& instance);
 };
\ No newline at end of file
@@ -15,4 +15,8 @@ glm::mat4 Camera::getViewMatrix() const {
 
 glm::vec3 Camera::getLookingVector() const {
     return glm::vec3(cos(pitch)*cos(yaw), sin(pitch), sin(yaw) * cos(pitch));
+}
+
+Frustum Camera::getFrustum(const glm::mat4& projection) const {
+    return Frustum::fromViewProjection(projection * getViewMatrix());
 }
\ No newline at end of file
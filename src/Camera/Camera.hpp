@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include "Utility/Frustum/Frustum.hpp"
+
 class Camera {
 public:
     float pitch, yaw;
@@ -12,4 +14,6 @@ public:
 
     glm::mat4 getViewMatrix() const;
     glm::vec3 getLookingVector() const;
+
+    Frustum getFrustum(const glm::mat4& projection) const;
 };
\ No newline at end of file
@@ -28,6 +28,18 @@ glm::mat4 CameraController::getViewMatrix() const {
     }
 }
 
+Frustum CameraController::getFrustum(const glm::mat4& projection) const {
+    return Frustum::fromViewProjection(projection * getViewMatrix());
+}
+
+glm::vec3 CameraController::getPosition() const {
+    if (cameraProgram != nullptr) {
+        return cameraProgramData.position;
+    } else {
+        return camera.pos;
+    }
+}
+
 const Camera& CameraController::getCamera() const {
     return camera;
 }
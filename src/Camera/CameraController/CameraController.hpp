@@ -27,6 +27,12 @@ public:
     ~CameraController();
 
     glm::mat4 getViewMatrix() const;
+
+    // What the view matrix sees through projection, follows the program while one runs
+    Frustum getFrustum(const glm::mat4& projection) const;
+
+    // Where the view matrix looks from, the program's position while one runs
+    glm::vec3 getPosition() const;
     const Camera& getCamera() const;
 
     void useProgram(std::shared_ptr<CameraProgram> program);
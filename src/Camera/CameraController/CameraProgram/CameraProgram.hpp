@@ -13,5 +13,5 @@ public:
 
     virtual CameraData tick(double deltaTime) = 0;
     virtual void reset() = 0;
-    virtual void drawPath(glm::mat4 viewMatrix, glm::mat4 viewProjection) = 0;
+    virtual void drawPath() = 0;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "QuarticBezierCurverProgram.hpp"
+#include "ShaderReflection.hpp"
 
 glm::vec3 QuarticBezierCurverProgram::calculateBezier(double _t) {
     double t1 = (1.0 - _t);
@@ -15,76 +16,22 @@ glm::vec3 QuarticBezierCurverProgram::calculateBezier(double _t) {
         + controlPoints[3] * glm::vec3(b3);
 }
 
-std::unique_ptr<ShaderProgram> QuarticBezierCurverProgram::loadBezierCurveShader() {
-    // Vertex shader
-    Shader vertexShader(GL_VERTEX_SHADER);
-    vertexShader.addSourceCodeFromPath("shader/bezier/vertex.glsl");
-    vertexShader.compile();
-
-    if (!vertexShader.isShaderCompiled()) {
-        std::string vertexShaderLog = vertexShader.getInfoLog();
-        std::cout << vertexShaderLog << '\n';
-        std::exit(1);
-    }
-
-    // Tesselation control shader
-    Shader tcsShader(GL_TESS_CONTROL_SHADER);
-    tcsShader.addSourceCodeFromPath("shader/bezier/tcs.glsl");
-    tcsShader.compile();
-
-    if (!tcsShader.isShaderCompiled()) {
-        std::string tcsShaderLog = tcsShader.getInfoLog();
-        std::cout << tcsShaderLog << '\n';
-        std::exit(1);
-    }
-
-    // Tesselation evaluation shader
-    Shader tesShader(GL_TESS_EVALUATION_SHADER);
-    tesShader.addSourceCodeFromPath("shader/bezier/tes.glsl");
-    tesShader.compile();
-
-    if (!tesShader.isShaderCompiled()) {
-        std::string tesShaderLog = tesShader.getInfoLog();
-        std::cout << tesShaderLog << '\n';
-        std::exit(1);
-    }
-
-    // Fragment shader
-    Shader fragmentShader(GL_FRAGMENT_SHADER);
-    fragmentShader.addSourceCodeFromPath("shader/bezier/fragment.glsl");
-    fragmentShader.compile();
-
-    if (!fragmentShader.isShaderCompiled()) {
-        std::string fragmentShaderLog = fragmentShader.getInfoLog();
-        std::cout << fragmentShaderLog << '\n';
-        std::exit(1);
-    }
-
-    auto program = std::make_unique<ShaderProgram>();
-
-    program->addShader(std::move(vertexShader));
-    program->addShader(std::move(tcsShader));
-    program->addShader(std::move(tesShader));
-    program->addShader(std::move(fragmentShader));
-
-    program->linkProgram();
-    if (!program->isProgramLinked()) {
-        std::string programLog = program->getInfoLog();
-        std::cout << programLog << '\n';
-        std::exit(1);
-    }
-
-    program->getShaderList().clear(); // Clear shaders not needed anymore after linking program
-
-    return program;
-}
-
-QuarticBezierCurverProgram::QuarticBezierCurverProgram(std::vector<glm::vec3> _controlPoints) {
+const ShaderProgramDescription QuarticBezierCurverProgram::pathShaderDescription = {
+    {
+        { GL_VERTEX_SHADER,          "shader/bezier/vertex.glsl" },
+        { GL_TESS_CONTROL_SHADER,    "shader/bezier/tcs.glsl" },
+        { GL_TESS_EVALUATION_SHADER, "shader/bezier/tes.glsl" },
+        { GL_FRAGMENT_SHADER,        "shader/bezier/fragment.glsl" },
+    },
+    {}
+};
+
+QuarticBezierCurverProgram::QuarticBezierCurverProgram(ShaderLibrary& shaderLibrary, std::vector<glm::vec3> _controlPoints) {
     controlPoints = _controlPoints;
     bezierVertexBuffer.bufferData(controlPoints);
+    bezierVertexArray.attachBuffer<VertexLayout<Attribute<ShaderReflection::bezier::attribute::vertexPos, glm::vec3>>>(bezierVertexBuffer.getBufferId());
 
-    bezierShader = loadBezierCurveShader();
-    bezierCurveViewProjectionUniform = bezierShader->getUniformLocation("viewProjection");
+    bezierShader = shaderLibrary.request(pathShaderDescription);
 
 }
 
@@ -107,20 +54,14 @@ void QuarticBezierCurverProgram::reset() {
     t = 0.f;
 }
 
-void QuarticBezierCurverProgram::drawPath(glm::mat4 viewMatrix, glm::mat4 viewProjection) {
+void QuarticBezierCurverProgram::drawPath() {
     // For drawing bezier curves
     glPatchParameteri(GL_PATCH_VERTICES, 4);
 
     bezierShader->use();
-    glUniformMatrix4fv(bezierCurveViewProjectionUniform, 1, GL_FALSE, &viewProjection[0][0]);
-
-	glBindBuffer(GL_ARRAY_BUFFER, bezierVertexBuffer.getBufferId());
-    glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
 
+    bezierVertexArray.bindVertexArray();
     glDrawArrays(GL_PATCHES, 0, 4);
-
-    glDisableVertexAttribArray(0);
 }
 
 void QuarticBezierCurverProgram::addSpeedFunction(std::function<double(double)> someFunction) {
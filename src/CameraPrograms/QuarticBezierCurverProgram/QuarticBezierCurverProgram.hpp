@@ -7,6 +7,8 @@
 #include "Camera/CameraController/CameraProgram/CameraProgram.hpp"
 #include "Utility/GL/Buffer/Buffer.hpp"
 #include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
+#include "Utility/GL/ShaderLibrary/ShaderLibrary.hpp"
+#include "Utility/GL/VertexArray/VertexArray.hpp"
 
 #include <glm/glm.hpp>
 
@@ -14,25 +16,25 @@ class QuarticBezierCurverProgram : public CameraProgram {
 private:
     std::vector<glm::vec3> controlPoints;
     Buffer<glm::vec3> bezierVertexBuffer;
+    VertexArray       bezierVertexArray;
 
     double t = 0.f;
     const double speed = .1f;
 
-    std::unique_ptr<ShaderProgram> bezierShader;
-    GLuint bezierCurveViewProjectionUniform;
+    std::shared_ptr<ShaderProgram> bezierShader;
 
     std::function<double(double)> speedFunc = [](double x) { return 1.0f; };
 
     glm::vec3 calculateBezier(double _t);
-
-    std::unique_ptr<ShaderProgram> loadBezierCurveShader();
 public:
-    QuarticBezierCurverProgram(std::vector<glm::vec3> controlPoints);
+    static const ShaderProgramDescription pathShaderDescription;
+
+    QuarticBezierCurverProgram(ShaderLibrary& shaderLibrary, std::vector<glm::vec3> controlPoints);
     ~QuarticBezierCurverProgram();
 
     CameraProgram::CameraData tick(double dt);
     void reset();
-    void drawPath(glm::mat4 viewMatrix, glm::mat4 viewProjection);
+    void drawPath();
     void addSpeedFunction(std::function<double(double)> someFunction);
     void setControlPoints(std::vector<glm::vec3> points);
 };
\ No newline at end of file
@@ -1,10 +1,22 @@
 #include "MyApp/MyApp.hpp"
 #include "OneMillionBeers/OneMillionBeers.hpp"
+#include "Benchmarks/Benchmark.hpp"
+
+#include <string>
+
+int main(int argc, char** argv) {
+    // Main --bench <name> runs a benchmark instead, Main --bench lists them
+    if (argc >= 2 && std::string(argv[1]) == "--bench") {
+        if (argc < 3) {
+            printBenchmarks();
+            return 0;
+        }
+        return runBenchmark(argv[2]) ? 0 : 1;
+    }
 
-int main() {
     auto game = std::make_unique<OneMillionBeers>();
     game->start();
     game->join();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -8,8 +8,16 @@
 #include "imgui/backends/imgui_impl_opengl3.h"
 
 #include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
+#include "Utility/GL/ShaderLibrary/ShaderLibrary.hpp"
 #include "Utility/GL/VertexArray/VertexArray.hpp"
 #include "Utility/GL/Buffer/Buffer.hpp"
+#include "Utility/GL/GLObjectCounter/GLObjectCounter.hpp"
+#include "Utility/GL/FrameUniforms/FrameUniforms.hpp"
+#include "Utility/GL/Sampler/Sampler.hpp"
+#include "Utility/GL/UploadQueue/UploadQueue.hpp"
+#include "Utility/GL/TextureManager/TextureManager.hpp"
+#include "Utility/ThreadPool/ThreadPool.hpp"
+#include "ShaderReflection.hpp"
 
 #include "Camera/CameraController/CameraController.hpp"
 #include "Camera/CameraController/CameraProgram/CameraProgram.hpp"
@@ -22,44 +30,13 @@
 #include <exception>
 #include <functional>
 
-static std::unique_ptr<ShaderProgram> loadObjectShader() {
-    Shader vertexShader(GL_VERTEX_SHADER);
-    vertexShader.addSourceCodeFromPath("./shader/object/vertex.glsl");
-    vertexShader.compile();
-
-    if (!vertexShader.isShaderCompiled()) {
-        std::string vertexShaderLog = vertexShader.getInfoLog();
-        std::cout << vertexShaderLog << '\n';
-        std::exit(1);
-    }
-
-    Shader fragmentShader(GL_FRAGMENT_SHADER);
-    fragmentShader.addSourceCodeFromPath("./shader/object/fragment.glsl");
-    fragmentShader.compile();
-
-    if (!fragmentShader.isShaderCompiled()) {
-        std::string fragmentShaderLog = fragmentShader.getInfoLog();
-        std::cout << fragmentShaderLog << '\n';
-        std::exit(1);
-    }
-
-    auto program = std::make_unique<ShaderProgram>();
-
-    program->addShader(std::move(vertexShader));
-    program->addShader(std::move(fragmentShader));
-
-    program->linkProgram();
-
-    if (!program->isProgramLinked()) {
-        std::string programLog = program->getInfoLog();
-        std::cout << programLog << '\n';
-        std::exit(1);
-    }
-
-    program->getShaderList().clear();
-
-    return program;
-}
+static const ShaderProgramDescription objectShaderDescription = {
+    {
+        { GL_VERTEX_SHADER,   "./shader/object/vertex.glsl" },
+        { GL_FRAGMENT_SHADER, "./shader/object/fragment.glsl" },
+    },
+    {}
+};
 
 void MyApp::init() {
     if (!glfwInit()) {
@@ -92,9 +69,14 @@ void MyApp::loop() {
 
     printf("Vendor: %s\nRenderer: %s\n", vendor, renderer);
 
-    // VAO
-    VertexArray vao;
-    vao.bindVertexArray();
+    // Kick off every shader compile before doing anything else, they build while the scene is set up
+    ShaderLibrary shaderLibrary;
+    shaderLibrary.enableHotReload("./shader");
+
+    auto objectShader = shaderLibrary.request(objectShaderDescription);
+    shaderLibrary.request(TexturedBillboard::shaderDescription);
+    shaderLibrary.request(BillboardRenderer::instancedShaderDescription);
+    shaderLibrary.request(QuarticBezierCurverProgram::pathShaderDescription);
 
     // Simple buffer
     Buffer<glm::vec3> vertexBuffer;
@@ -195,6 +177,11 @@ void MyApp::loop() {
     vertexBuffer.bufferData(vertexData);
     colorBuffer.bufferData(colorData);
 
+    // VAO
+    VertexArray vao;
+    vao.attachBuffer<VertexLayout<Attribute<ShaderReflection::object::attribute::vertexPosition, glm::vec3>>>(vertexBuffer.getBufferId());
+    vao.attachBuffer<VertexLayout<Attribute<ShaderReflection::object::attribute::colorValue, glm::vec3>>>(colorBuffer.getBufferId());
+
     // Camera stuff
     CameraController cameraController(glm::vec3(4, 5, 0));
 
@@ -204,26 +191,38 @@ void MyApp::loop() {
         glm::vec3(30, 30, 25),
         glm::vec3(32, 40, 50)
     };
-    auto bezierCameraProgram = std::make_shared<QuarticBezierCurverProgram>(cameraProgramControlPoints);
+    auto bezierCameraProgram = std::make_shared<QuarticBezierCurverProgram>(shaderLibrary, cameraProgramControlPoints);
     // bezierCameraProgram->addSpeedFunction([](double x) { return .1 * std::cos(9.f * x) + .2 * std::sin(3.f * x - .6f) + .8; });
 
-    BillboardRenderer billboardRenderer;
+    BillboardRenderer billboardRenderer(shaderLibrary);
 
-    auto texture = std::make_shared<Texture>();
-    texture->loadFromFilePath("onebeerplease.jpg");
+    // Images are baked on workers, the billboards show a placeholder until theirs is uploaded.
+    // Finer mip levels are streamed in as the camera gets close, within the budget.
+    ThreadPool     threadPool;
+    UploadQueue    uploadQueue(threadPool);
+    int            textureBudgetKB = 256;
+    TextureManager textureManager(threadPool, uploadQueue, textureBudgetKB * 1024);
+
+    // Textured billboards sample unit 0
+    auto billboardSampler = Sampler::get(SamplerDescription::anisotropic(8.f));
+    billboardSampler->bind(0);
 
     for (int i=0; i<250; i++) {
-        auto myTexturedBillboard = std::make_shared<TexturedBillboard>(billboardRenderer);
-        myTexturedBillboard->billboardTexture = texture;
-        myTexturedBillboard->size = glm::vec2(3, 7);
-        myTexturedBillboard->position = glm::vec3(i*3, 0, 0);
+        // Loading per billboard is fine, every path is baked and uploaded once.
+        // The beer is an opaque photo, BC1 keeps it at an eighth of the RGBA8 size.
+        auto texture = i % 10 == 0 ? textureManager.load("kanye.png", BlockFormat::BC7) : textureManager.load("onebeerplease.jpg", BlockFormat::BC1);
 
-        billboardRenderer.drawObjects.push_back(myTexturedBillboard);
+        billboardRenderer.store.add(glm::vec3(i*3, 0, 0), glm::vec2(3, 7), billboardRenderer.getTextureId(texture));
     }
 
-    // Object shader
-    auto objectShader = loadObjectShader();
-    GLuint objectViewProjectionUniform = objectShader->getUniformLocation("viewProjection");
+    std::vector<float> textureScreenSizes;
+
+    std::cout << "GL buffer objects in scene: " << GLObjectCounter::getLiveBufferCount() << '\n';
+
+    shaderLibrary.finishAll();
+
+    // Camera, fog and time for every program
+    FrameUniforms frameUniforms;
 
     glClearColor(.25f, .5f, .75f, 1.0f);
 	glEnable(GL_DEPTH_TEST);
@@ -236,6 +235,8 @@ void MyApp::loop() {
     bool isShowingPath = false;
 
     double lastFrameStartTime = glfwGetTime();
+
+    ShaderProgram::UniformStats lastFrameUniformStats;
     
     while(!glfwWindowShouldClose(window) && glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS) {
         double frameStartTime = glfwGetTime();
@@ -244,16 +245,42 @@ void MyApp::loop() {
         double deltaTime = frameStartTime - lastFrameStartTime;
     
         glfwPollEvents();
+
+        // Swap in edited shaders
+        shaderLibrary.update();
+
+        // Pick up finished uploads
+        uploadQueue.process();
+        textureManager.update();
+
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         int windowWidth, windowHeight;
         glfwGetWindowSize(window, &windowWidth, &windowHeight);
         
         // 3D Math stuff...
-        glm::mat4 viewMatrix = cameraController.getViewMatrix();
         glm::mat4 projectionMatrix = glm::perspective(glm::radians(60.0f), (float)windowWidth / (float)windowHeight, 0.1f, 100.0f);
 
-        glm::mat4 viewProjection = projectionMatrix * viewMatrix;
+        frameUniforms.update(cameraController, projectionMatrix, frameStartTime, deltaTime);
+
+        // Mip levels the billboards need next frame
+        {
+            // Largest screen size of each texture, one request per texture
+            const BillboardStore& store = billboardRenderer.store;
+            textureScreenSizes.assign(store.getTextureIdLimit(), 0.f);
+
+            for (std::size_t i=0; i<store.getCount(); i++) {
+                const float distance = glm::length(store.getPositions()[i] - cameraController.getPosition());
+                const float screenSize = TextureManager::getScreenSize(store.getSizes()[i].y, distance, projectionMatrix, windowHeight);
+
+                float& textureScreenSize = textureScreenSizes[store.getTextureIds()[i]];
+                textureScreenSize = std::max(textureScreenSize, screenSize);
+            }
+
+            for (std::uint32_t textureId=0; textureId<textureScreenSizes.size(); textureId++) {
+                textureManager.requestSize(*billboardRenderer.getTexture(textureId), textureScreenSizes[textureId]);
+            }
+        }
         
         // Camera controller logic
         cameraController.step(window, deltaTime);
@@ -307,31 +334,40 @@ void MyApp::loop() {
                 bezierCameraProgram->setControlPoints(cameraProgramControlPoints);
             }
 
+            ImGui::Separator();
+            ImGui::Text("Uniform uploads: %zu (%zu elided)", lastFrameUniformStats.uploads, lastFrameUniformStats.elided);
+
+            ImGui::Text("Billboard draw calls: %zu", billboardRenderer.getLastDrawCallCount());
+
+            ImGui::Separator();
+            if (ImGui::SliderInt("Texture budget (KB)", &textureBudgetKB, 16, 4096)) {
+                textureManager.setBudget(textureBudgetKB * 1024);
+            }
+
+            const TextureManager::Stats textureStats = textureManager.getStats();
+            ImGui::Text("Textures: %zu, %.1f / %.1f KB resident", textureStats.textureCount, textureStats.residentBytes / 1024.0, textureStats.budgetBytes / 1024.0);
+            ImGui::Text("Mip levels streamed in %zu, evicted %zu (%zu pending)", textureStats.streamedLevels, textureStats.evictedLevels, textureStats.pendingUploads);
+            ImGui::Text("Texture loads: %zu cache hits, %zu misses", textureStats.cache.hits, textureStats.cache.misses);
+
         ImGui::End();
 
-        billboardRenderer.draw(viewMatrix, viewProjection);
+        billboardRenderer.draw();
 
-        if (isShowingPath) bezierCameraProgram->drawPath(viewMatrix, viewProjection);
+        if (isShowingPath) bezierCameraProgram->drawPath();
 
         objectShader->use();
-        glUniformMatrix4fv(objectViewProjectionUniform, 1, GL_FALSE, &viewProjection[0][0]);
 
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer.getBufferId());
-        glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-
-		glBindBuffer(GL_ARRAY_BUFFER, colorBuffer.getBufferId());
-        glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+        vao.bindVertexArray();
 
         // Render objects
         glDrawArrays(GL_TRIANGLES, 0, vertexData.size());
-        glDisableVertexAttribArray(0);
-        glDisableVertexAttribArray(1);
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+        lastFrameUniformStats = ShaderProgram::getUniformStats();
+        ShaderProgram::resetUniformStats();
+
         // Frame limiter
         const double frameEndTime = glfwGetTime();
         const double frameTimeMS = (frameEndTime - frameStartTime) * 1e6;
@@ -6,52 +6,42 @@
 #include "Utility/GL/VertexArray/VertexArray.hpp"
 #include "Utility/GL/Buffer/Buffer.hpp"
 #include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
-#include "Utility/GL/Texture/Texture.hpp"
+#include "Utility/GL/ShaderLibrary/ShaderLibrary.hpp"
+#include "Utility/GL/TextureAtlas/TextureAtlas.hpp"
+#include "Utility/GL/GpuTimer/GpuTimer.hpp"
+#include "Utility/GL/GpuQuery/GpuQuery.hpp"
+#include "Utility/GL/Sampler/Sampler.hpp"
+#include "Utility/GL/UploadQueue/UploadQueue.hpp"
+#include "Utility/GL/FrameUniforms/FrameUniforms.hpp"
+#include "Utility/GL/StreamBuffer/StreamBuffer.hpp"
+#include "ShaderReflection.hpp"
+#include "Utility/ThreadPool/ThreadPool.hpp"
+#include "Utility/ParallelCuller/ParallelCuller.hpp"
+#include "Utility/ChunkGrid/ChunkGrid.hpp"
+#include "Utility/Utility.hpp"
+#include "Utility/Image/Image.hpp"
 
 #include "Camera/CameraController/CameraController.hpp"
 
+#include "InstanceEncoding/InstanceEncoding.hpp"
+#include "GpuInstanceCuller/GpuInstanceCuller.hpp"
+
 #include <iostream>
 #include <vector>
-
-static std::unique_ptr<ShaderProgram> loadShader() {
-    Shader vertexShader(GL_VERTEX_SHADER);
-    vertexShader.addSourceCodeFromPath("./shader/instancing/vertex.glsl");
-    vertexShader.compile();
-
-    if (!vertexShader.isShaderCompiled()) {
-        std::string vertexShaderLog = vertexShader.getInfoLog();
-        std::cout << vertexShaderLog << '\n';
-        std::exit(1);
-    }
-
-    Shader fragmentShader(GL_FRAGMENT_SHADER);
-    fragmentShader.addSourceCodeFromPath("./shader/instancing/fragment.glsl");
-    fragmentShader.compile();
-
-    if (!fragmentShader.isShaderCompiled()) {
-        std::string fragmentShaderLog = fragmentShader.getInfoLog();
-        std::cout << fragmentShaderLog << '\n';
-        std::exit(1);
-    }
-
-    auto program = std::make_unique<ShaderProgram>();
-
-    program->addShader(std::move(vertexShader));
-    program->addShader(std::move(fragmentShader));
-
-    program->linkProgram();
-
-    if (!program->isProgramLinked()) {
-        std::string programLog = program->getInfoLog();
-        std::cout << programLog << '\n';
-        std::exit(1);
-    }
-
-    program->getShaderList().clear();
-
-    return program;
-}
-
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstring>
+
+static const ShaderProgramDescription instancingShaderDescription = {
+    {
+        { GL_VERTEX_SHADER,   "./shader/instancing/vertex.glsl" },
+        { GL_FRAGMENT_SHADER, "./shader/instancing/fragment.glsl" },
+    },
+    // Every beer has the same size and the texture is stored upside down
+    { "FOG", "BILLBOARD_SIZE vec2(3, 7)", "FLIP_TEXTURE_Y" }
+};
 
 void OneMillionBeers::init() {
     if (!glfwInit()) {
@@ -91,82 +81,261 @@ static std::vector<glm::vec2> billboardUVData = {
     glm::vec2(1, 1),
 };
 
+// Where the visible set is built, press C to switch to the next one
+enum class CullingMode {
+    Off,
+    Chunks, // ChunkGrid, whole chunks drawn straight from the static buffers
+    CPU,    // ParallelCuller on the thread pool, compacted into stream buffers
+    GPU,    // GpuInstanceCuller, the count never comes back to the CPU
+
+    Count
+};
+
+static const char* getCullingModeName(CullingMode mode) {
+    switch (mode) {
+        case CullingMode::Off:    return "off";
+        case CullingMode::Chunks: return "chunks";
+        case CullingMode::CPU:    return "CPU";
+        case CullingMode::GPU:    return "GPU";
+        default:                  return "unknown";
+    }
+}
+
+// The beer field, built on a worker and handed to the render thread once its instances are uploaded.
+// posArray, the positions split into columns for culling and the current encoding stay on the CPU,
+// the visible instances get compacted from them every frame.
+struct FieldData {
+    std::vector<glm::vec3> posArray;
+    std::vector<float> positionX, positionY, positionZ;
+
+    // Which image every beer shows, one in sixteen is not a beer
+    std::vector<std::uint16_t> regionArray;
+
+    std::unique_ptr<InstanceEncoding> instanceEncoding;
+    std::unique_ptr<ChunkGrid> chunkGrid;
+};
+
+// Copy the encoded instances at indices to destination, one fixed size copy per instance
+template <std::size_t BytesPerInstance>
+static void gatherInstances(const std::uint8_t* source, std::uint8_t* destination, std::span<const std::uint32_t> indices) {
+    for (std::size_t i=0; i<indices.size(); i++) {
+        std::memcpy(destination + i * BytesPerInstance, source + indices[i] * BytesPerInstance, BytesPerInstance);
+    }
+}
+
 void OneMillionBeers::loop() {
-    // VAO
-    VertexArray vao;
-    vao.bindVertexArray();
+    // Compiles while the rest is set up, the first uniform lookup waits for it
+    ShaderLibrary shaderLibrary;
+    shaderLibrary.enableHotReload("./shader");
+    auto shaderProgram = shaderLibrary.request(instancingShaderDescription);
+
+    // Heavy resources are built on workers and uploaded a few MB per frame
+    ThreadPool  threadPool;
+    UploadQueue uploadQueue(threadPool);
 
     Buffer<glm::vec2> billboardVertexBuffer;
     Buffer<glm::vec2> billboardUVBuffer;
-    Buffer<glm::vec3> billboardPositionBuffer;
 
     billboardVertexBuffer.bufferData(billboardUVData);
     billboardUVBuffer.bufferData(billboardUVData);
 
     CameraController cameraController(glm::vec3(0, 0, 0));
 
-    auto shaderProgram = loadShader();
-    GLuint textureUniform = shaderProgram->getUniformLocation("myTexture");
+    FrameUniforms frameUniforms;
 
-    GLuint viewMatrixUniform = shaderProgram->getUniformLocation("viewMatrix");
-    GLuint viewProjectionUniform = shaderProgram->getUniformLocation("viewProjection");
+    UniformHandle textureUniform = shaderProgram->getUniformHandle(ShaderReflection::instancing::uniform::myTexture);
 
-    GLuint cameraPositionUniform = shaderProgram->getUniformLocation("cameraPosition");
+    UniformHandle instanceOriginUniform = shaderProgram->getUniformHandle(ShaderReflection::instancing::uniform::instanceOrigin);
+    UniformHandle instanceScaleUniform = shaderProgram->getUniformHandle(ShaderReflection::instancing::uniform::instanceScale);
 
-    GLuint fogMinUniform = shaderProgram->getUniformLocation("fogMin");
-    GLuint fogMaxUniform = shaderProgram->getUniformLocation("fogMax");
-    GLuint fogColorUniform = shaderProgram->getUniformLocation("fogColor");
+    const int BillboardCount = 1000000;
 
-    Texture beerTexture;
-    beerTexture.loadFromFilePath("onebeerplease.jpg");
+    // Beers along one side of a ChunkGrid chunk, Main --bench chunk-grid sweeps this
+    const int ChunkSide = 32;
 
-    const int BillboardCount = 1000000;
+    // Every quad spans position to position + BILLBOARD_SIZE facing the camera, a sphere as wide as its diagonal holds it
+    const float billboardRadius = glm::length(glm::vec2(3, 7));
 
-    std::vector<glm::vec3> posArray;
+    // Every image the field uses goes into one atlas, so all beers stay a single draw.
+    // The images are decoded on workers and packed in a fixed order, the index of a path in
+    // atlasImagePaths is its region index.
+    TextureAtlas textureAtlas(1024, 2);
+    bool isAtlasReady = false;
 
-    for (int i=0; i<BillboardCount; i++) {
-        float x = i % 500;
-        float z = i / 500;
+    const std::vector<std::string> atlasImagePaths = { "onebeerplease.jpg", "kanye.png" };
+    std::vector<std::future<std::optional<Image>>> atlasImageFutures;
 
-        posArray.push_back(glm::vec3(x, 0.f, z)*glm::vec3(5));
+    for (const std::string& path : atlasImagePaths) {
+        atlasImageFutures.push_back(threadPool.submit([path]() { return Image::loadFromFile(path); }));
     }
 
-    billboardPositionBuffer.bufferData(posArray);
+    std::future<std::shared_ptr<Buffer<std::uint16_t>>> regionBufferFuture;
+    std::shared_ptr<Buffer<std::uint16_t>> billboardRegionBuffer;
+
+    InstanceFormat instanceFormat = InstanceFormat::UNorm16;
+
+    // Build the field on a worker, bucket it into chunks and store the beers chunk by chunk.
+    // The worker holds its own reference to pendingField, the render thread only takes it over as field once the upload is done
+    auto pendingField = std::make_shared<FieldData>();
+    std::shared_ptr<FieldData> field;
+
+    auto instanceBufferFuture = uploadQueue.uploadBuffer<std::uint8_t>([pendingField, instanceFormat, billboardRadius]() {
+        std::vector<glm::vec3> fieldPositions;
+        std::vector<std::uint16_t> fieldRegions;
+
+        for (int i=0; i<BillboardCount; i++) {
+            float x = i % 500;
+            float z = i / 500;
+
+            fieldPositions.push_back(glm::vec3(x, 0.f, z)*glm::vec3(5));
+            fieldRegions.push_back(hashBytes(&i, sizeof(i)) % 16 == 0 ? 1 : 0);
+        }
+
+        pendingField->chunkGrid = std::make_unique<ChunkGrid>(fieldPositions, ChunkSide * 5.f, billboardRadius);
+
+        pendingField->posArray    = pendingField->chunkGrid->reorder<glm::vec3>(fieldPositions);
+        pendingField->regionArray = pendingField->chunkGrid->reorder<std::uint16_t>(fieldRegions);
+
+        for (const glm::vec3& position : pendingField->posArray) {
+            pendingField->positionX.push_back(position.x);
+            pendingField->positionY.push_back(position.y);
+            pendingField->positionZ.push_back(position.z);
+        }
+
+        pendingField->instanceEncoding = std::make_unique<InstanceEncoding>(instanceFormat, pendingField->posArray);
+        return pendingField->instanceEncoding->data;
+    });
+
+    CullingMode cullingMode = CullingMode::Chunks;
+
+    // Chunk culling, the instance ranges of the visible chunks
+    std::vector<InstanceRange> chunkRanges;
+
+    // CPU culling, the visible beers are compacted into these every frame and only they are drawn
+    ParallelCuller culler(threadPool);
+
+    StreamBuffer<std::uint8_t>  visibleInstanceStream(BillboardCount * InstanceEncoding::getBytesPerInstance(InstanceFormat::Float32));
+    StreamBuffer<std::uint16_t> visibleRegionStream(BillboardCount);
+
+    // GPU culling, compute on GL 4.3+ and transform feedback below
+    GpuInstanceCuller gpuCuller(shaderLibrary, instancingShaderDescription, billboardVertexBuffer.getBufferId(), billboardUVBuffer.getBufferId(), BillboardCount);
+    GpuTimer gpuCullTimer;
+
+    printf("GPU culling path: %s\n", GpuInstanceCuller::getPathName(gpuCuller.getPath()));
+    std::shared_ptr<Buffer<std::uint8_t>> billboardInstanceBuffer;
+
+    // VAO
+    VertexArray vao;
+    vao.attachBuffer<VertexLayout<Attribute<ShaderReflection::instancing::attribute::vertexPosition, glm::vec2>>>(billboardVertexBuffer.getBufferId());
+    vao.attachBuffer<VertexLayout<Attribute<ShaderReflection::instancing::attribute::textureCoordinates, glm::vec2>>>(billboardUVBuffer.getBufferId());
 
     shaderProgram->use();
 
+    // Point the per instance attribute at the encoded positions
+    auto attachInstanceEncoding = [&](const InstanceEncoding& encoding) {
+        encoding.attach(vao, billboardInstanceBuffer->getBufferId());
+
+        shaderProgram->set(instanceOriginUniform, encoding.origin);
+        shaderProgram->set(instanceScaleUniform, encoding.scale);
+    };
+
+    auto attachRegionBuffer = [&](GLuint buffer, GLintptr offset) {
+        vao.attachBuffer<VertexLayout<IntegerAttribute<ShaderReflection::instancing::attribute::textureRegion, std::uint16_t, 1>>>(buffer, offset);
+    };
+
+    // Draw instances first .. first + count - 1 of the static buffers
+    auto drawInstanceRange = [&](std::uint32_t first, std::uint32_t count) {
+        if (GLAD_GL_VERSION_4_2) {
+            glDrawArraysInstancedBaseInstance(GL_QUADS, 0, 4, count, first);
+        } else {
+            // No base instance on GL 4.1, point the instance attributes at the range instead
+            field->instanceEncoding->attach(vao, billboardInstanceBuffer->getBufferId(), first * field->instanceEncoding->getBytesPerInstance());
+            attachRegionBuffer(billboardRegionBuffer->getBufferId(), first * sizeof(std::uint16_t));
+
+            glDrawArraysInstanced(GL_QUADS, 0, 4, count);
+        }
+    };
+
+    // Re-encode the positions in another format and upload them
+    auto applyInstanceFormat = [&](InstanceFormat format) {
+        field->instanceEncoding = std::make_unique<InstanceEncoding>(format, field->posArray);
+
+        billboardInstanceBuffer->bufferData(field->instanceEncoding->data);
+        attachInstanceEncoding(*field->instanceEncoding);
+    };
+
     // Set fog parameters
     const float fogMinimim = 500.f;
     const float fogMaximum = 1000.f;
     const glm::vec3 fogColor(.25f, .5f, .75f);
 
-    glUniform1f(fogMinUniform, fogMinimim);
-    glUniform1f(fogMaxUniform, fogMaximum);
-    glUniform3fv(fogColorUniform, 1, &fogColor[0]);
-
-    // Use texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, beerTexture.getTextureId());
-    glUniform1i(textureUniform, 0);
-
-    double lastFrameStartTime = glfwGetTime();
+    frameUniforms.setFog(fogColor, fogMinimim, fogMaximum);
 
-    // Setup our vertex attributes
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
+    // Use texture unit 0, the texture gets bound there once it is uploaded
+    shaderProgram->set(textureUniform, 0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, billboardVertexBuffer.getBufferId());
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    // Filtering modes to compare, press M to switch to the next one
+    const std::pair<const char*, SamplerDescription> filterModes[] = {
+        { "nearest, no mips",  SamplerDescription::nearest() },
+        { "bilinear, no mips", SamplerDescription::bilinear() },
+        { "trilinear",         SamplerDescription::trilinear() },
+        { "anisotropic 16x",   SamplerDescription::anisotropic(16.f) },
+    };
+    const int filterModeCount = sizeof(filterModes) / sizeof(filterModes[0]);
+    int filterMode = 2;
 
-    glBindBuffer(GL_ARRAY_BUFFER, billboardUVBuffer.getBufferId());
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    std::shared_ptr<Sampler> beerSampler = Sampler::get(filterModes[filterMode].second);
+    beerSampler->bind(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, billboardPositionBuffer.getBufferId());
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    double lastFrameStartTime = glfwGetTime();
 
-    // Only change billboard position when we start a new instance
-    glVertexAttribDivisor(2, 1);
+    // Benchmark, press P to switch to the next instance format or M to the next filtering mode.
+    // Prints the numbers of the format / mode that was active since the last switch.
+    GpuTimer drawTimer;
+    GpuQuery drawFragments(GL_SAMPLES_PASSED);
+
+    bool isFormatButtonPressed = false;
+    bool isFilterButtonPressed = false;
+    bool isCullingButtonPressed = false;
+
+    double benchmarkGpuTimeTotal = 0;
+    double benchmarkFrameTimeTotal = 0;
+    double benchmarkFragmentsTotal = 0;
+    double benchmarkCullTimeTotal = 0;
+    double benchmarkVisibleTotal = 0;
+    int    benchmarkVisibleFrameCount = 0; // The GPU keeps its visible count to itself
+    int    benchmarkFrameCount = 0;
+
+    auto printBenchmark = [&](const std::string& label) {
+        const int frames = std::max(benchmarkFrameCount, 1);
+        const double gpuMs = benchmarkGpuTimeTotal / frames;
+        const double fragments = benchmarkFragmentsTotal / frames;
+
+        char visibleShare[16] = "    ?";
+        if (benchmarkVisibleFrameCount > 0) {
+            snprintf(visibleShare, sizeof(visibleShare), "%5.1f", benchmarkVisibleTotal / benchmarkVisibleFrameCount * 100.0 / BillboardCount);
+        }
+
+        printf(
+            "%-60s GPU draw %6.3f ms, frame %6.3f ms, cull %6.3f ms, %s%% visible, %6.2f M fragments, %5.2f G fragments/s (%d frames)\n",
+            label.c_str(),
+            gpuMs,
+            benchmarkFrameTimeTotal / frames,
+            benchmarkCullTimeTotal / frames,
+            visibleShare,
+            fragments / 1e6,
+            gpuMs > 0 ? fragments / (gpuMs * 1e6) : 0.0,
+            benchmarkFrameCount
+        );
+
+        benchmarkGpuTimeTotal = 0;
+        benchmarkFrameTimeTotal = 0;
+        benchmarkFragmentsTotal = 0;
+        benchmarkCullTimeTotal = 0;
+        benchmarkVisibleTotal = 0;
+        benchmarkVisibleFrameCount = 0;
+        benchmarkFrameCount = 0;
+    };
 
     while(!glfwWindowShouldClose(window) && glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS) {
         double frameStartTime = glfwGetTime();
@@ -175,34 +344,212 @@ void OneMillionBeers::loop() {
         double deltaTime = frameStartTime - lastFrameStartTime;
     
         glfwPollEvents();
+
+        // Swap in edited shaders
+        shaderLibrary.update();
+
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         int windowWidth, windowHeight;
         glfwGetWindowSize(window, &windowWidth, &windowHeight);
         
         // 3D Math stuff...
-        glm::mat4 viewMatrix = cameraController.getViewMatrix();
         glm::mat4 projectionMatrix = glm::perspective(glm::radians(60.0f), (float)windowWidth / (float)windowHeight, 0.1f, fogMaximum);
 
-        glm::mat4 viewProjection = projectionMatrix * viewMatrix;
-        
+        // Send the camera to the gpu, one upload for every program
+        frameUniforms.update(cameraController, projectionMatrix, frameStartTime, deltaTime);
+
+        // Cull against the same view the frame is drawn with
+        const Frustum frustum = cameraController.getFrustum(projectionMatrix);
+
         // Camera controller logic
         cameraController.step(window, deltaTime);
-        glm::vec3 cameraPosition = cameraController.getCamera().pos;
-
-        // Send the matrices to the gpu
-        glUniformMatrix4fv(viewMatrixUniform, 1, GL_FALSE, &viewMatrix[0][0]);
-        glUniformMatrix4fv(viewProjectionUniform, 1, GL_FALSE, &viewProjection[0][0]);
 
-        // Used for fog calculation
-        glUniform3fv(cameraPositionUniform, 1, &cameraPosition[0]);
+        // Pick up finished uploads
+        uploadQueue.process();
+
+        if (instanceBufferFuture.valid() && instanceBufferFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            billboardInstanceBuffer = instanceBufferFuture.get();
+            field = std::move(pendingField);
+            attachInstanceEncoding(*field->instanceEncoding);
+
+            // The regions are in chunk order now too
+            regionBufferFuture = uploadQueue.uploadBuffer<std::uint16_t>([field]() { return field->regionArray; });
+        }
+
+        if (regionBufferFuture.valid() && regionBufferFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            billboardRegionBuffer = regionBufferFuture.get();
+            attachRegionBuffer(billboardRegionBuffer->getBufferId(), 0);
+        }
+
+        const bool areAtlasImagesDecoded = std::all_of(atlasImageFutures.begin(), atlasImageFutures.end(), [](std::future<std::optional<Image>>& future) {
+            return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+
+        if (!isAtlasReady && areAtlasImagesDecoded) {
+            for (std::size_t i=0; i<atlasImageFutures.size(); i++) {
+                // Keep the region indices in order, an image that can't be loaded or packed becomes a single white texel
+                const Image white = { 1, 1, { 255, 255, 255, 255 } };
+                Image image = atlasImageFutures[i].get().value_or(white);
+
+                if (!textureAtlas.add(image.pixels.data(), image.width, image.height)) {
+                    std::cout << "Failed to add " << atlasImagePaths[i] << " to the texture atlas, drawing it white\n";
+                    textureAtlas.add(white.pixels.data(), white.width, white.height);
+                }
+            }
+            atlasImageFutures.clear();
+
+            textureAtlas.bind(0);
+            isAtlasReady = true;
+        }
+
+        // Switch instance format
+        if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && billboardInstanceBuffer != nullptr) {
+            if (isFormatButtonPressed == false) {
+                isFormatButtonPressed = true;
+
+                const std::size_t bytesPerInstance = InstanceEncoding::getBytesPerInstance(instanceFormat);
+
+                char label[128];
+                snprintf(
+                    label, sizeof(label), "%s, %zu bytes/instance, %.1f MB/frame",
+                    InstanceEncoding::getFormatName(instanceFormat),
+                    bytesPerInstance,
+                    bytesPerInstance * BillboardCount / 1e6
+                );
+                printBenchmark(label);
+
+                instanceFormat = (InstanceFormat)(((int)instanceFormat + 1) % (int)InstanceFormat::Count);
+                applyInstanceFormat(instanceFormat);
+            }
+        } else {
+            isFormatButtonPressed = false;
+        }
+
+        // Switch texture filtering
+        if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
+            if (isFilterButtonPressed == false) {
+                isFilterButtonPressed = true;
+
+                printBenchmark(std::string("Filtering ") + filterModes[filterMode].first);
+
+                filterMode = (filterMode + 1) % filterModeCount;
+                beerSampler = Sampler::get(filterModes[filterMode].second);
+                beerSampler->bind(0);
+            }
+        } else {
+            isFilterButtonPressed = false;
+        }
+
+        // Switch culling mode
+        if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && billboardInstanceBuffer != nullptr && billboardRegionBuffer != nullptr) {
+            if (isCullingButtonPressed == false) {
+                isCullingButtonPressed = true;
+
+                printBenchmark(std::string("Culling ") + getCullingModeName(cullingMode));
+
+                cullingMode = (CullingMode)(((int)cullingMode + 1) % (int)CullingMode::Count);
+
+                // Back to every beer in the static buffers, CPU culling points the instance attributes at the stream buffers
+                attachInstanceEncoding(*field->instanceEncoding);
+                attachRegionBuffer(billboardRegionBuffer->getBufferId(), 0);
+            }
+        } else {
+            isCullingButtonPressed = false;
+        }
 
         // Render objects
-        glDrawArraysInstanced(GL_QUADS, 0, 4, BillboardCount);
+        if (billboardInstanceBuffer != nullptr && billboardRegionBuffer != nullptr && isAtlasReady) {
+            GLsizei instanceCount = BillboardCount;
+
+            if (cullingMode == CullingMode::GPU) {
+                // Cull, append and draw without the CPU touching a single beer
+                gpuCullTimer.begin();
+                gpuCuller.cull(*field->instanceEncoding, billboardInstanceBuffer->getBufferId(), billboardRegionBuffer->getBufferId(), billboardRadius);
+                gpuCullTimer.end();
+
+                drawTimer.begin();
+                drawFragments.begin();
+                gpuCuller.draw(0);
+                drawFragments.end();
+                drawTimer.end();
+
+                benchmarkCullTimeTotal += gpuCullTimer.getLastResultMs();
+            } else if (cullingMode == CullingMode::Chunks) {
+                // A few thousand chunk bounds instead of a million beers
+                const auto cullStartTime = std::chrono::steady_clock::now();
+                field->chunkGrid->cull(frustum, chunkRanges);
+
+                benchmarkCullTimeTotal += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cullStartTime).count();
+                instanceCount = field->chunkGrid->getLastVisibleInstanceCount();
+            } else if (cullingMode == CullingMode::CPU) {
+                // Cull and compact on the workers, straight into this frame's region of the stream buffers
+                std::span<std::uint8_t>  visibleInstances = visibleInstanceStream.beginFrame();
+                std::span<std::uint16_t> visibleRegions   = visibleRegionStream.beginFrame();
+
+                const std::uint8_t* encodedInstances = field->instanceEncoding->data.data();
+                const std::size_t bytesPerInstance = field->instanceEncoding->getBytesPerInstance();
+
+                const SphereArrays billboardSpheres = { field->positionX.data(), field->positionY.data(), field->positionZ.data(), nullptr, billboardRadius };
+
+                instanceCount = culler.cull(frustum, billboardSpheres, BillboardCount, [&](std::span<const std::uint32_t> visibleIndices, std::size_t outputOffset) {
+                    std::uint8_t* destination = visibleInstances.data() + outputOffset * bytesPerInstance;
+
+                    switch (bytesPerInstance) {
+                        case 4:  gatherInstances<4>(encodedInstances, destination, visibleIndices); break;
+                        case 8:  gatherInstances<8>(encodedInstances, destination, visibleIndices); break;
+                        default: gatherInstances<12>(encodedInstances, destination, visibleIndices); break;
+                    }
+
+                    for (std::size_t i=0; i<visibleIndices.size(); i++) {
+                        visibleRegions[outputOffset + i] = field->regionArray[visibleIndices[i]];
+                    }
+                });
+
+                visibleInstanceStream.endWrites();
+                visibleRegionStream.endWrites();
+
+                field->instanceEncoding->attach(vao, visibleInstanceStream.getBufferId(), visibleInstanceStream.getFrameOffset());
+                attachRegionBuffer(visibleRegionStream.getBufferId(), visibleRegionStream.getFrameOffset());
+
+                benchmarkCullTimeTotal += culler.getLastStats().cullMs + culler.getLastStats().compactMs;
+            }
+
+            if (cullingMode != CullingMode::GPU) {
+                benchmarkVisibleTotal += instanceCount;
+                benchmarkVisibleFrameCount++;
+
+                shaderProgram->use();
+                vao.bindVertexArray();
+
+                drawTimer.begin();
+                drawFragments.begin();
+
+                if (cullingMode == CullingMode::Chunks) {
+                    for (const InstanceRange& range : chunkRanges) drawInstanceRange(range.first, range.count);
+                } else {
+                    glDrawArraysInstanced(GL_QUADS, 0, 4, instanceCount);
+                }
+
+                drawFragments.end();
+                drawTimer.end();
+            }
+
+            if (cullingMode == CullingMode::CPU) {
+                visibleInstanceStream.endFrame();
+                visibleRegionStream.endFrame();
+            }
+        }
 
         // Frame limiter
         const double frameEndTime = glfwGetTime();
         const double frameTimeMS = (frameEndTime - frameStartTime) * 1e6;
+
+        benchmarkGpuTimeTotal += drawTimer.getLastResultMs();
+        benchmarkFrameTimeTotal += frameTimeMS / 1e3;
+        benchmarkFragmentsTotal += drawFragments.getLastResult();
+        benchmarkFrameCount++;
+
         const double requiredFrameTimeMS = 8333.33;
         const double sleepTime = requiredFrameTimeMS - frameTimeMS;
 
@@ -0,0 +1,218 @@
+#include "GpuInstanceCuller.hpp"
+
+#include "ShaderReflection.hpp"
+
+#include <algorithm>
+
+static_assert(sizeof(VisibleInstance) == 16, "VisibleInstance must match the std430 layout of the cull shader and the feedback varyings");
+
+static const ShaderProgramDescription::Stage computeStage  = { GL_COMPUTE_SHADER,  "./shader/instancing/cull/compute.glsl" };
+static const ShaderProgramDescription::Stage feedbackStages[] = {
+    { GL_VERTEX_SHADER,   "./shader/instancing/feedback/vertex.glsl" },
+    { GL_GEOMETRY_SHADER, "./shader/instancing/feedback/geometry.glsl" },
+};
+
+// Define selecting the decoder of the cull shader, Float32 is the default
+static std::vector<std::string> getFormatDefines(InstanceFormat format) {
+    switch (format) {
+        case InstanceFormat::Half16:           return { "FORMAT_HALF16" };
+        case InstanceFormat::UNorm16:          return { "FORMAT_UNORM16" };
+        case InstanceFormat::Packed10_10_10_2: return { "FORMAT_PACKED10_10_10_2" };
+        default:                               return { };
+    }
+}
+
+GpuInstanceCuller::GpuInstanceCuller(ShaderLibrary& shaderLibrary, const ShaderProgramDescription& drawDescription, GLuint quadVertexBuffer, GLuint quadUVBuffer, std::size_t _capacity, Path _path):
+    path(_path),
+    capacity(_capacity)
+{
+    visibleBuffer.allocate(capacity);
+
+    if (path == Path::Compute) {
+        for (std::size_t format=0; format<(std::size_t)InstanceFormat::Count; format++) {
+            computePrograms[format] = shaderLibrary.request({ { computeStage }, getFormatDefines((InstanceFormat)format) });
+        }
+        // A variant of its own reading the decoded positions, so the uniforms of drawDescription stay untouched
+        ShaderProgramDescription decodedDrawDescription = drawDescription;
+        decodedDrawDescription.defines.push_back("DECODED_POSITIONS");
+        drawProgram = shaderLibrary.request(decodedDrawDescription);
+
+        const DrawArraysIndirectCommand command = { 4, 0, 0, 0 };
+        commandBuffer.bufferData({ &command, 1 });
+
+        drawVao.attachBuffer<VertexLayout<Attribute<ShaderReflection::instancing::attribute::vertexPosition, glm::vec2>>>(quadVertexBuffer);
+        drawVao.attachBuffer<VertexLayout<Attribute<ShaderReflection::instancing::attribute::textureCoordinates, glm::vec2>>>(quadUVBuffer);
+        drawVao.attachBuffer<VertexLayout<
+            InstanceAttribute<ShaderReflection::instancing::attribute::billboardPosition, glm::vec3>,
+            IntegerAttribute<ShaderReflection::instancing::attribute::textureRegion, std::uint32_t, 1>
+        >>(visibleBuffer.getBufferId());
+    } else {
+        feedbackProgram = shaderLibrary.request({
+            { feedbackStages[0], feedbackStages[1] },
+            { },
+            { "visiblePosition", "visibleRegion" }
+        });
+
+        // Same quads and fog as drawDescription, built from points
+        pointProgram = shaderLibrary.request({
+            {
+                { GL_VERTEX_SHADER,   "./shader/instancing/points/vertex.glsl" },
+                { GL_GEOMETRY_SHADER, "./shader/instancing/points/geometry.glsl" },
+                { GL_FRAGMENT_SHADER, "./shader/instancing/fragment.glsl" },
+            },
+            drawDescription.defines
+        });
+
+        glGenTransformFeedbacks(1, &feedback);
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, feedback);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, visibleBuffer.getBufferId());
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+
+        glGenQueries(1, &primitivesWrittenQuery);
+
+        // Compatibility contexts draw nothing without attribute 0 enabled, the instances themselves start at location 2
+        cullVao.attachBuffer<VertexLayout<Attribute<0, glm::vec2>>>(quadVertexBuffer);
+
+        drawVao.attachBuffer<VertexLayout<
+            Attribute<ShaderReflection::instancing_points::attribute::billboardPosition, glm::vec3>,
+            IntegerAttribute<ShaderReflection::instancing_points::attribute::textureRegion, std::uint32_t>
+        >>(visibleBuffer.getBufferId());
+    }
+}
+
+GpuInstanceCuller::~GpuInstanceCuller() {
+    if (feedback != 0) glDeleteTransformFeedbacks(1, &feedback);
+    if (primitivesWrittenQuery != 0) glDeleteQueries(1, &primitivesWrittenQuery);
+}
+
+void GpuInstanceCuller::cull(const InstanceEncoding& encoding, GLuint instanceBuffer, GLuint regionBuffer, float boundingRadius) {
+    if (path == Path::Compute) {
+        cullWithCompute(encoding, instanceBuffer, regionBuffer, boundingRadius);
+    } else {
+        cullWithFeedback(encoding, instanceBuffer, regionBuffer, boundingRadius);
+    }
+}
+
+void GpuInstanceCuller::cullWithCompute(const InstanceEncoding& encoding, GLuint instanceBuffer, GLuint regionBuffer, float boundingRadius) {
+    // Instances past capacity have nowhere to go
+    const std::size_t count = std::min(encoding.count, capacity);
+
+    ShaderProgram& program = *computePrograms[(std::size_t)encoding.format];
+
+    program.set(ShaderReflection::instancing_cull::uniform::totalInstanceCount, (unsigned int)count);
+    program.set(ShaderReflection::instancing_cull::uniform::boundingRadius, boundingRadius);
+    program.set(ShaderReflection::instancing_cull::uniform::instanceOrigin, encoding.origin);
+    program.set(ShaderReflection::instancing_cull::uniform::instanceScale, encoding.scale);
+
+    // Start appending from zero again
+    const DrawArraysIndirectCommand command = { 4, 0, 0, 0 };
+    commandBuffer.bufferData({ &command, 1 });
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, regionBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, visibleBuffer.getBufferId());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, commandBuffer.getBufferId());
+
+    program.use();
+    glDispatchCompute((count + 255) / 256, 1, 1);
+
+    // The draw reads the appended instances as vertex attributes and its parameters from the command
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+void GpuInstanceCuller::cullWithFeedback(const InstanceEncoding& encoding, GLuint instanceBuffer, GLuint regionBuffer, float boundingRadius) {
+    const std::size_t count = std::min(encoding.count, capacity);
+
+    feedbackProgram->set(ShaderReflection::instancing_feedback::uniform::boundingRadius, boundingRadius);
+    feedbackProgram->set(ShaderReflection::instancing_feedback::uniform::instanceOrigin, encoding.origin);
+    feedbackProgram->set(ShaderReflection::instancing_feedback::uniform::instanceScale, encoding.scale);
+
+    // Read the instances exactly like the instanced draw does, the encoding may have changed since the last cull
+    encoding.attach(cullVao, instanceBuffer);
+    cullVao.attachBuffer<VertexLayout<IntegerAttribute<ShaderReflection::instancing_feedback::attribute::textureRegion, std::uint16_t, 1>>>(regionBuffer);
+
+    feedbackProgram->use();
+    cullVao.bindVertexArray();
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, feedback);
+
+    glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, primitivesWrittenQuery);
+    glBeginTransformFeedback(GL_POINTS);
+
+    // One point per instance
+    glDrawArraysInstanced(GL_POINTS, 0, 1, count);
+
+    glEndTransformFeedback();
+    glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+    glDisable(GL_RASTERIZER_DISCARD);
+}
+
+void GpuInstanceCuller::draw(GLint atlasTextureUnit) {
+    if (path == Path::Compute) {
+        drawProgram->set(ShaderReflection::instancing::uniform::myTexture, atlasTextureUnit);
+
+        drawProgram->use();
+        drawVao.bindVertexArray();
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer.getBufferId());
+        glDrawArraysIndirect(GL_QUADS, nullptr);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    } else {
+        pointProgram->set(ShaderReflection::instancing::uniform::myTexture, atlasTextureUnit);
+
+        pointProgram->use();
+        drawVao.bindVertexArray();
+
+        glDrawTransformFeedback(GL_POINTS, feedback);
+    }
+}
+
+GpuInstanceCuller::Path GpuInstanceCuller::getPath() const {
+    return path;
+}
+
+std::vector<VisibleInstance> GpuInstanceCuller::readVisibleInstances() {
+    GLuint visibleCount = 0;
+
+    if (path == Path::Compute) {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        DrawArraysIndirectCommand command;
+        glBindBuffer(GL_COPY_READ_BUFFER, commandBuffer.getBufferId());
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(command), &command);
+
+        visibleCount = command.instanceCount;
+    } else {
+        glGetQueryObjectuiv(primitivesWrittenQuery, GL_QUERY_RESULT, &visibleCount);
+    }
+
+    std::vector<VisibleInstance> result(std::min<std::size_t>(visibleCount, capacity));
+
+    glBindBuffer(GL_COPY_READ_BUFFER, visibleBuffer.getBufferId());
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(VisibleInstance) * result.size(), result.data());
+
+    return result;
+}
+
+GpuInstanceCuller::Path GpuInstanceCuller::getBestPath() {
+    return isPathSupported(Path::Compute) ? Path::Compute : Path::TransformFeedback;
+}
+
+bool GpuInstanceCuller::isPathSupported(Path path) {
+    switch (path) {
+        case Path::Compute:           return GLAD_GL_VERSION_4_3;
+        case Path::TransformFeedback: return GLAD_GL_VERSION_4_1;
+        default:                      return false;
+    }
+}
+
+const char* GpuInstanceCuller::getPathName(Path path) {
+    switch (path) {
+        case Path::Compute:           return "compute";
+        case Path::TransformFeedback: return "transform feedback";
+        default:                      return "unknown";
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+
+#include "Utility/GL/Buffer/Buffer.hpp"
+#include "Utility/GL/VertexArray/VertexArray.hpp"
+#include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
+#include "Utility/GL/ShaderLibrary/ShaderLibrary.hpp"
+
+#include "OneMillionBeers/InstanceEncoding/InstanceEncoding.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+// One visible instance in the culled output, 16 bytes on both paths
+struct VisibleInstance {
+    glm::vec3     position;
+    std::uint32_t region;
+};
+
+// Layout of the glDrawArraysIndirect parameters
+struct DrawArraysIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint first;
+    GLuint baseInstance;
+};
+
+// Culls encoded instances on the GPU against the frustum and fog distance of the current FrameUniforms and draws the
+// visible ones, the visible count never leaves the GPU. Two paths:
+//   Compute (GL 4.3+):          a compute shader appends visible instances with an atomic counter, which is the
+//                               instance count of the indirect command glDrawArraysIndirect draws the quads with
+//   TransformFeedback (GL 4.1): one point per instance goes through a geometry shader that drops the invisible ones,
+//                               with the rasterizer discarded. glDrawTransformFeedback draws the captured points,
+//                               expanded to quads by a second geometry shader (4.1 has no way to get the captured
+//                               count into an indirect command without reading it back)
+class GpuInstanceCuller {
+public:
+    enum class Path {
+        Compute,
+        TransformFeedback,
+    };
+private:
+    Path path;
+    std::size_t capacity;
+
+    // Compute path, one variant per InstanceFormat
+    std::array<std::shared_ptr<ShaderProgram>, (std::size_t)InstanceFormat::Count> computePrograms;
+    std::shared_ptr<ShaderProgram> drawProgram;
+
+    Buffer<DrawArraysIndirectCommand> commandBuffer;
+
+    // Transform feedback path
+    std::shared_ptr<ShaderProgram> feedbackProgram;
+    std::shared_ptr<ShaderProgram> pointProgram;
+
+    GLuint feedback = 0;
+    GLuint primitivesWrittenQuery = 0;
+
+    VertexArray cullVao; // Reads the encoded instances and regions
+    VertexArray drawVao; // Quad vertices and visible instances on the compute path, visible points on the other
+
+    Buffer<VisibleInstance> visibleBuffer;
+
+    void cullWithCompute(const InstanceEncoding& encoding, GLuint instanceBuffer, GLuint regionBuffer, float boundingRadius);
+    void cullWithFeedback(const InstanceEncoding& encoding, GLuint instanceBuffer, GLuint regionBuffer, float boundingRadius);
+public:
+    GpuInstanceCuller(const GpuInstanceCuller&) = delete; // non construction-copyable
+    GpuInstanceCuller& operator=(const GpuInstanceCuller&) = delete; // non copyable
+
+    // drawDescription is the program the instances are normally drawn with (shader/instancing). The culled instances are
+    // drawn with its DECODED_POSITIONS variant, its defines are used for the point expanding program as well. Quads are read from quadVertexBuffer / quadUVBuffer like the instanced draw does.
+    GpuInstanceCuller(ShaderLibrary& shaderLibrary, const ShaderProgramDescription& drawDescription, GLuint quadVertexBuffer, GLuint quadUVBuffer, std::size_t capacity, Path path = getBestPath());
+    ~GpuInstanceCuller();
+
+    // Cull the instances of encoding stored in instanceBuffer with their 16 bit atlas regions in regionBuffer.
+    // Uses the FrameUniforms of the current frame, so update those first.
+    void cull(const InstanceEncoding& encoding, GLuint instanceBuffer, GLuint regionBuffer, float boundingRadius);
+
+    // Draw what the last cull() left visible, with the atlas bound to atlasTextureUnit
+    void draw(GLint atlasTextureUnit = 0);
+
+    Path getPath() const;
+
+    // Read the result of the last cull() back, waits for the GPU. For tests only.
+    std::vector<VisibleInstance> readVisibleInstances();
+
+    // Compute on GL 4.3+
+    static Path getBestPath();
+    static bool isPathSupported(Path path);
+    static const char* getPathName(Path path);
+};
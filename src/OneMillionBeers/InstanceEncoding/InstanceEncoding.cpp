@@ -0,0 +1,139 @@
+#include "InstanceEncoding.hpp"
+
+#include "ShaderReflection.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <cstring>
+
+static constexpr GLuint InstancePositionLocation = ShaderReflection::instancing::attribute::billboardPosition;
+
+template <typename T>
+static void writeInstance(std::vector<std::uint8_t>& data, std::size_t index, T value) {
+    std::memcpy(&data[index * sizeof(T)], &value, sizeof(T));
+}
+
+template <typename T>
+static T readInstance(const std::vector<std::uint8_t>& data, std::size_t index) {
+    T value;
+    std::memcpy(&value, &data[index * sizeof(T)], sizeof(T));
+    return value;
+}
+
+InstanceEncoding::InstanceEncoding(InstanceFormat _format, std::span<const glm::vec3> positions, glm::vec3 boundsMin, glm::vec3 boundsMax):
+    format(_format),
+    count(positions.size())
+{
+    data.resize(getBytesPerInstance() * count);
+
+    // Avoid dividing by zero on flat axes (the beer field has no height)
+    glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(1e-6f));
+
+    switch (format) {
+        case InstanceFormat::Float32:
+            origin = glm::vec3(0);
+            scale  = glm::vec3(1);
+            std::memcpy(data.data(), positions.data(), data.size());
+            break;
+
+        case InstanceFormat::Half16:
+            // Centering halves the magnitudes and so doubles the precision we get out of 11 bits of mantissa
+            origin = (boundsMin + boundsMax) * .5f;
+            scale  = glm::vec3(1);
+            for (std::size_t i=0; i<count; i++) {
+                writeInstance<std::uint64_t>(data, i, glm::packHalf4x16(glm::vec4(positions[i] - origin, 0)));
+            }
+            break;
+
+        case InstanceFormat::UNorm16:
+            origin = boundsMin;
+            scale  = extent;
+            for (std::size_t i=0; i<count; i++) {
+                writeInstance<std::uint64_t>(data, i, glm::packUnorm4x16(glm::vec4((positions[i] - origin) / scale, 0)));
+            }
+            break;
+
+        case InstanceFormat::Packed10_10_10_2:
+            origin = boundsMin;
+            scale  = extent;
+            for (std::size_t i=0; i<count; i++) {
+                writeInstance<std::uint32_t>(data, i, glm::packUnorm3x10_1x2(glm::vec4((positions[i] - origin) / scale, 0)));
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static glm::vec3 getBoundsMin(std::span<const glm::vec3> positions) {
+    glm::vec3 result = positions.empty() ? glm::vec3(0) : positions[0];
+    for (const glm::vec3& p : positions) result = glm::min(result, p);
+    return result;
+}
+
+static glm::vec3 getBoundsMax(std::span<const glm::vec3> positions) {
+    glm::vec3 result = positions.empty() ? glm::vec3(0) : positions[0];
+    for (const glm::vec3& p : positions) result = glm::max(result, p);
+    return result;
+}
+
+InstanceEncoding::InstanceEncoding(InstanceFormat _format, std::span<const glm::vec3> positions):
+    InstanceEncoding(_format, positions, getBoundsMin(positions), getBoundsMax(positions)) {}
+
+std::size_t InstanceEncoding::getBytesPerInstance() const {
+    return getBytesPerInstance(format);
+}
+
+glm::vec3 InstanceEncoding::decode(std::size_t index) const {
+    glm::vec3 stored(0);
+
+    switch (format) {
+        case InstanceFormat::Float32:          stored = readInstance<glm::vec3>(data, index); break;
+        case InstanceFormat::Half16:           stored = glm::unpackHalf4x16(readInstance<std::uint64_t>(data, index)); break;
+        case InstanceFormat::UNorm16:          stored = glm::unpackUnorm4x16(readInstance<std::uint64_t>(data, index)); break;
+        case InstanceFormat::Packed10_10_10_2: stored = glm::unpackUnorm3x10_1x2(readInstance<std::uint32_t>(data, index)); break;
+        default:                               break;
+    }
+
+    return origin + stored * scale;
+}
+
+void InstanceEncoding::attach(VertexArray& vao, GLuint buffer, GLintptr offset) const {
+    switch (format) {
+        case InstanceFormat::Float32:
+            vao.attachBuffer<VertexLayout<InstanceAttribute<InstancePositionLocation, glm::vec3>>>(buffer, offset);
+            break;
+        case InstanceFormat::Half16:
+            vao.attachBuffer<VertexLayout<VertexAttribute<InstancePositionLocation, 4, GL_HALF_FLOAT, 8, false, 1>>>(buffer, offset);
+            break;
+        case InstanceFormat::UNorm16:
+            vao.attachBuffer<VertexLayout<VertexAttribute<InstancePositionLocation, 4, GL_UNSIGNED_SHORT, 8, true, 1>>>(buffer, offset);
+            break;
+        case InstanceFormat::Packed10_10_10_2:
+            vao.attachBuffer<VertexLayout<VertexAttribute<InstancePositionLocation, 4, GL_UNSIGNED_INT_2_10_10_10_REV, 4, true, 1>>>(buffer, offset);
+            break;
+        default:
+            break;
+    }
+}
+
+std::size_t InstanceEncoding::getBytesPerInstance(InstanceFormat format) {
+    switch (format) {
+        case InstanceFormat::Float32:          return 12;
+        case InstanceFormat::Half16:           return 8;
+        case InstanceFormat::UNorm16:          return 8;
+        case InstanceFormat::Packed10_10_10_2: return 4;
+        default:                               return 0;
+    }
+}
+
+const char* InstanceEncoding::getFormatName(InstanceFormat format) {
+    switch (format) {
+        case InstanceFormat::Float32:          return "Float32";
+        case InstanceFormat::Half16:           return "Half16";
+        case InstanceFormat::UNorm16:          return "UNorm16";
+        case InstanceFormat::Packed10_10_10_2: return "Packed10_10_10_2";
+        default:                               return "Unknown";
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Utility/GL/VertexArray/VertexArray.hpp"
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// How per instance positions are stored in the instance buffer
+enum class InstanceFormat {
+    Float32,          // 3x float,              12 bytes
+    Half16,           // 4x half float,          8 bytes, relative to the bounds center
+    UNorm16,          // 4x 16 bit normalized,   8 bytes, relative to the bounds origin
+    Packed10_10_10_2, // 10_10_10_2 normalized,  4 bytes, relative to the bounds origin
+
+    Count
+};
+
+// Per instance positions encoded in one of the InstanceFormats.
+// The shader decodes them with: position = instanceOrigin + stored.xyz * instanceScale
+class InstanceEncoding {
+public:
+    InstanceFormat format;
+
+    glm::vec3 origin;
+    glm::vec3 scale;
+
+    std::vector<std::uint8_t> data;
+    std::size_t count;
+
+    // Encode positions relative to the box boundsMin..boundsMax (usually the chunk the instances live in)
+    InstanceEncoding(InstanceFormat format, std::span<const glm::vec3> positions, glm::vec3 boundsMin, glm::vec3 boundsMax);
+
+    // Encode positions relative to their own bounding box
+    InstanceEncoding(InstanceFormat format, std::span<const glm::vec3> positions);
+
+    std::size_t getBytesPerInstance() const;
+
+    // Position of instance index the way the shaders decode it, origin + stored * scale
+    glm::vec3 decode(std::size_t index) const;
+
+    // Bake the matching attribute setup for instance attribute location 2 into vao
+    void attach(VertexArray& vao, GLuint buffer, GLintptr offset = 0) const;
+
+    static std::size_t getBytesPerInstance(InstanceFormat format);
+    static const char* getFormatName(InstanceFormat format);
+};
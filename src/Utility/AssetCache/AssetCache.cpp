@@ -0,0 +1,13 @@
+#include "AssetCache.hpp"
+
+#include <filesystem>
+
+std::string getAssetKey(const std::string& path, const std::string& options) {
+    std::error_code error;
+    std::string key = std::filesystem::weakly_canonical(std::filesystem::absolute(path, error), error).string();
+
+    if (error) key = path;
+    if (!options.empty()) key += "|" + options;
+
+    return key;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <unordered_map>
+#include <list>
+#include <vector>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+// Canonical path plus whatever load options change the result, so "./a.png" and "a.png" share an entry
+std::string getAssetKey(const std::string& path, const std::string& options = "");
+
+// Hands out one shared asset per key, loading it only when nobody holds it anymore.
+//
+// The cache only keeps weak references, an asset lives as long as someone holds its handle.
+// With a keep warm count the last that many assets whose handles were all dropped stay alive, so
+// releasing and requesting again in the next frame doesn't load twice. Assets are released on
+// whichever thread drops the last handle or evicts them from the warm list, for GL objects that has
+// to be the thread owning the context.
+template <typename T>
+class AssetCache {
+private:
+    struct Entry {
+        std::weak_ptr<T> handle;
+        std::shared_ptr<T> warm; // Only set while on the warm list
+        typename std::list<std::string>::iterator warmPosition;
+    };
+
+    // Shared with the handle deleters, which may outlive the cache
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::list<std::string> warmKeys; // Most recently released at the front
+        std::size_t keepWarmCount = 0;
+
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+
+        // Returns what fell off the warm list, to be destroyed outside the lock
+        std::vector<std::shared_ptr<T>> trimWarm() {
+            std::vector<std::shared_ptr<T>> evicted;
+
+            while (warmKeys.size() > keepWarmCount) {
+                Entry& entry = entries[warmKeys.back()];
+                evicted.push_back(std::move(entry.warm));
+                entries.erase(warmKeys.back());
+                warmKeys.pop_back();
+            }
+
+            return evicted;
+        }
+    };
+
+    std::shared_ptr<State> state = std::make_shared<State>();
+
+    // Handles get their own control block whose deleter parks the asset on the warm list
+    // instead of destroying it
+    std::shared_ptr<T> makeHandle(const std::string& key, std::shared_ptr<T> asset) {
+        T* pointer = asset.get();
+        std::weak_ptr<State> weakState = state;
+
+        std::shared_ptr<T> handle(pointer, [weakState, key, asset = std::move(asset)](T*) mutable {
+            std::shared_ptr<State> state = weakState.lock();
+            if (!state) return;
+
+            std::vector<std::shared_ptr<T>> evicted;
+            {
+                std::lock_guard lock(state->mutex);
+
+                // Someone may have loaded it again in the meantime
+                auto it = state->entries.find(key);
+                if (it == state->entries.end() || !it->second.handle.expired()) return;
+
+                if (state->keepWarmCount == 0) {
+                    state->entries.erase(it);
+                    return;
+                }
+
+                it->second.warm = std::move(asset);
+                state->warmKeys.push_front(key);
+                it->second.warmPosition = state->warmKeys.begin();
+
+                evicted = state->trimWarm();
+            }
+        });
+
+        return handle;
+    }
+public:
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t liveCount = 0; // Held by someone
+        std::size_t warmCount = 0; // Only held by the cache
+    };
+
+    AssetCache(const AssetCache&) = delete; // non construction-copyable
+    AssetCache& operator=(const AssetCache&) = delete; // non copyable
+
+    AssetCache(std::size_t keepWarmCount = 0) {
+        state->keepWarmCount = keepWarmCount;
+    }
+
+    // The asset stored under key, or whatever load returns stored under it. Nothing from load is not cached.
+    std::shared_ptr<T> get(const std::string& key, const std::function<std::shared_ptr<T>()>& load) {
+        {
+            std::lock_guard lock(state->mutex);
+
+            auto it = state->entries.find(key);
+            if (it != state->entries.end()) {
+                if (auto handle = it->second.handle.lock()) {
+                    state->hits++;
+                    return handle;
+                }
+
+                // Bring it back from the warm list
+                if (it->second.warm) {
+                    state->warmKeys.erase(it->second.warmPosition);
+
+                    std::shared_ptr<T> handle = makeHandle(key, std::move(it->second.warm));
+                    it->second.handle = handle;
+
+                    state->hits++;
+                    return handle;
+                }
+            }
+        }
+
+        // Loaded outside the lock, load may well use other caches
+        std::shared_ptr<T> asset = load();
+
+        std::lock_guard lock(state->mutex);
+        state->misses++;
+
+        if (asset == nullptr) return nullptr;
+
+        std::shared_ptr<T> handle = makeHandle(key, std::move(asset));
+        state->entries[key].handle = handle;
+
+        return handle;
+    }
+
+    void setKeepWarmCount(std::size_t keepWarmCount) {
+        std::vector<std::shared_ptr<T>> evicted;
+        {
+            std::lock_guard lock(state->mutex);
+            state->keepWarmCount = keepWarmCount;
+            evicted = state->trimWarm();
+        }
+    }
+
+    // Let go of every warm asset, held ones stay shared
+    void clearWarm() {
+        std::vector<std::shared_ptr<T>> evicted;
+        {
+            std::lock_guard lock(state->mutex);
+            const std::size_t keepWarmCount = state->keepWarmCount;
+
+            state->keepWarmCount = 0;
+            evicted = state->trimWarm();
+            state->keepWarmCount = keepWarmCount;
+        }
+    }
+
+    Stats getStats() const {
+        std::lock_guard lock(state->mutex);
+
+        Stats stats;
+        stats.hits      = state->hits;
+        stats.misses    = state->misses;
+        stats.warmCount = state->warmKeys.size();
+
+        for (auto& [_, entry] : state->entries) {
+            if (!entry.handle.expired()) stats.liveCount++;
+        }
+
+        return stats;
+    }
+};
@@ -0,0 +1,515 @@
+#include "BlockCompression.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+// 4x4 texels in row order, channels 0..255
+using Block = std::array<glm::vec4, 16>;
+
+// Decoded 4x4 texels in row order
+using DecodedBlock = std::array<std::array<std::uint8_t, 4>, 16>;
+
+const char* getBlockFormatName(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1: return "BC1";
+        case BlockFormat::BC3: return "BC3";
+        case BlockFormat::BC7: return "BC7";
+    }
+    return "unknown";
+}
+
+std::size_t getBlockBytes(BlockFormat format) {
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+std::size_t getCompressedSize(BlockFormat format, std::size_t width, std::size_t height) {
+    return ((width + 3) / 4) * ((height + 3) / 4) * getBlockBytes(format);
+}
+
+static Block readBlock(const Image& image, std::size_t blockX, std::size_t blockY) {
+    Block block;
+
+    for (std::size_t y=0; y<4; y++) {
+        for (std::size_t x=0; x<4; x++) {
+            const std::size_t sourceX = std::min(blockX*4 + x, image.width - 1);
+            const std::size_t sourceY = std::min(blockY*4 + y, image.height - 1);
+            const std::uint8_t* texel = &image.pixels[(sourceY*image.width + sourceX) * 4];
+
+            block[y*4 + x] = glm::vec4(texel[0], texel[1], texel[2], texel[3]);
+        }
+    }
+
+    return block;
+}
+
+// Endpoints at the extremes of the block projected onto its principal axis.
+// channelMask zeroes channels that are not part of the fit (alpha for BC1).
+static void fitEndpoints(const Block& block, glm::vec4 channelMask, glm::vec4& a, glm::vec4& b) {
+    glm::vec4 mean(0);
+    for (auto& texel : block) mean += texel * channelMask;
+    mean /= 16.f;
+
+    glm::mat4 covariance(0);
+    for (auto& texel : block) {
+        glm::vec4 delta = texel * channelMask - mean;
+        covariance += glm::outerProduct(delta, delta);
+    }
+
+    // Power iteration, a few steps are plenty for a 4x4 block
+    glm::vec4 axis = channelMask;
+    for (int i=0; i<8; i++) {
+        axis = covariance * axis;
+
+        const float length = glm::length(axis);
+        if (length < 1e-6f) {
+            a = b = mean;
+            return;
+        }
+        axis /= length;
+    }
+
+    float minT = 0, maxT = 0;
+    for (auto& texel : block) {
+        const float t = glm::dot(texel * channelMask - mean, axis);
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    a = glm::clamp(mean + axis * minT, glm::vec4(0), glm::vec4(255));
+    b = glm::clamp(mean + axis * maxT, glm::vec4(0), glm::vec4(255));
+}
+
+// Least squares endpoints for the chosen indices, weights[i] is how far texel i is from a towards b.
+// Leaves a and b alone when every texel uses the same weight.
+static void refineEndpoints(const Block& block, const float weights[16], glm::vec4 channelMask, glm::vec4& a, glm::vec4& b) {
+    float aa = 0, ab = 0, bb = 0;
+    glm::vec4 ac(0), bc(0);
+
+    for (int i=0; i<16; i++) {
+        const float w = weights[i];
+        aa += (1 - w) * (1 - w);
+        ab += (1 - w) * w;
+        bb += w * w;
+        ac += (1 - w) * block[i] * channelMask;
+        bc += w * block[i] * channelMask;
+    }
+
+    const float determinant = aa*bb - ab*ab;
+    if (std::abs(determinant) < 1e-6f) return;
+
+    a = glm::clamp((ac*bb - bc*ab) / determinant, glm::vec4(0), glm::vec4(255));
+    b = glm::clamp((bc*aa - ac*ab) / determinant, glm::vec4(0), glm::vec4(255));
+}
+
+static float distanceSquared(glm::vec4 a, glm::vec4 b, glm::vec4 channelMask) {
+    glm::vec4 delta = (a - b) * channelMask;
+    return glm::dot(delta, delta);
+}
+
+// Index of the closest palette entry for every texel, returns the summed squared error
+template <std::size_t PaletteSize>
+static float selectIndices(const Block& block, const std::array<glm::vec4, PaletteSize>& palette, glm::vec4 channelMask, std::uint8_t indices[16]) {
+    float error = 0;
+
+    for (int i=0; i<16; i++) {
+        float bestDistance = distanceSquared(block[i], palette[0], channelMask);
+        indices[i] = 0;
+
+        for (std::size_t p=1; p<PaletteSize; p++) {
+            const float distance = distanceSquared(block[i], palette[p], channelMask);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                indices[i] = p;
+            }
+        }
+
+        error += bestDistance;
+    }
+
+    return error;
+}
+
+// BC1 color block, also the color half of BC3
+
+static std::uint16_t packRGB565(glm::vec4 color) {
+    const unsigned r = (unsigned)std::lround(color.r * 31.f / 255.f);
+    const unsigned g = (unsigned)std::lround(color.g * 63.f / 255.f);
+    const unsigned b = (unsigned)std::lround(color.b * 31.f / 255.f);
+    return (r << 11) | (g << 5) | b;
+}
+
+static glm::vec4 unpackRGB565(std::uint16_t color) {
+    const unsigned r = (color >> 11) & 31;
+    const unsigned g = (color >> 5) & 63;
+    const unsigned b = color & 31;
+    return glm::vec4((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255);
+}
+
+static std::array<glm::vec4, 4> getColorPalette(std::uint16_t color0, std::uint16_t color1) {
+    const glm::vec4 p0 = unpackRGB565(color0);
+    const glm::vec4 p1 = unpackRGB565(color1);
+    return { p0, p1, glm::floor((2.f*p0 + p1) / 3.f), glm::floor((p0 + 2.f*p1) / 3.f) };
+}
+
+static void encodeColorBlock(const Block& block, std::uint8_t* out) {
+    const glm::vec4 rgb(1, 1, 1, 0);
+
+    // How far each index is from color0 towards color1
+    static const float indexWeights[4] = { 0.f, 1.f, 1.f/3.f, 2.f/3.f };
+
+    glm::vec4 a, b;
+    fitEndpoints(block, rgb, a, b);
+
+    std::uint16_t bestColor0 = 0, bestColor1 = 0;
+    std::uint8_t  bestIndices[16] = {};
+    float         bestError = INFINITY;
+
+    for (int iteration=0; iteration<2; iteration++) {
+        std::uint16_t color0 = packRGB565(a);
+        std::uint16_t color1 = packRGB565(b);
+
+        // color0 > color1 selects the 4 color mode
+        if (color0 < color1) std::swap(color0, color1);
+
+        std::uint8_t indices[16];
+        float error;
+
+        if (color0 == color1) {
+            std::fill(indices, indices + 16, 0);
+            error = selectIndices<1>(block, { unpackRGB565(color0) }, rgb, indices);
+        } else {
+            error = selectIndices<4>(block, getColorPalette(color0, color1), rgb, indices);
+        }
+
+        if (error < bestError) {
+            bestError  = error;
+            bestColor0 = color0;
+            bestColor1 = color1;
+            std::memcpy(bestIndices, indices, 16);
+        }
+
+        if (color0 == color1) break;
+
+        float weights[16];
+        for (int i=0; i<16; i++) weights[i] = indexWeights[indices[i]];
+
+        a = unpackRGB565(color0);
+        b = unpackRGB565(color1);
+        refineEndpoints(block, weights, rgb, a, b);
+    }
+
+    std::uint32_t packedIndices = 0;
+    for (int i=0; i<16; i++) packedIndices |= (std::uint32_t)bestIndices[i] << (i*2);
+
+    out[0] = bestColor0 & 0xff;
+    out[1] = bestColor0 >> 8;
+    out[2] = bestColor1 & 0xff;
+    out[3] = bestColor1 >> 8;
+    std::memcpy(out + 4, &packedIndices, 4);
+}
+
+static void decodeColorBlock(const std::uint8_t* in, DecodedBlock& texels, bool alwaysFourColors) {
+    const std::uint16_t color0 = in[0] | (in[1] << 8);
+    const std::uint16_t color1 = in[2] | (in[3] << 8);
+
+    std::uint32_t packedIndices;
+    std::memcpy(&packedIndices, in + 4, 4);
+
+    std::array<glm::vec4, 4> palette = getColorPalette(color0, color1);
+
+    // BC1 blocks with color0 <= color1 have a midpoint and transparent black instead
+    if (color0 <= color1 && !alwaysFourColors) {
+        palette[2] = glm::floor((palette[0] + palette[1]) / 2.f);
+        palette[3] = glm::vec4(0);
+    }
+
+    for (int i=0; i<16; i++) {
+        const glm::vec4& color = palette[(packedIndices >> (i*2)) & 3];
+        texels[i] = { (std::uint8_t)color.r, (std::uint8_t)color.g, (std::uint8_t)color.b, (std::uint8_t)color.a };
+    }
+}
+
+// BC3 alpha block
+
+static std::array<int, 8> getAlphaPalette(int alpha0, int alpha1) {
+    if (alpha0 > alpha1) {
+        return {
+            alpha0, alpha1,
+            (6*alpha0 + 1*alpha1) / 7, (5*alpha0 + 2*alpha1) / 7, (4*alpha0 + 3*alpha1) / 7,
+            (3*alpha0 + 4*alpha1) / 7, (2*alpha0 + 5*alpha1) / 7, (1*alpha0 + 6*alpha1) / 7,
+        };
+    }
+
+    return {
+        alpha0, alpha1,
+        (4*alpha0 + 1*alpha1) / 5, (3*alpha0 + 2*alpha1) / 5, (2*alpha0 + 3*alpha1) / 5, (1*alpha0 + 4*alpha1) / 5,
+        0, 255,
+    };
+}
+
+static void encodeAlphaBlock(const Block& block, std::uint8_t* out) {
+    int alpha0 = 0, alpha1 = 255;
+    for (auto& texel : block) {
+        alpha0 = std::max(alpha0, (int)texel.a);
+        alpha1 = std::min(alpha1, (int)texel.a);
+    }
+
+    std::uint64_t packedIndices = 0;
+
+    if (alpha0 != alpha1) {
+        const std::array<int, 8> palette = getAlphaPalette(alpha0, alpha1);
+
+        for (int i=0; i<16; i++) {
+            int bestIndex = 0;
+            for (int p=1; p<8; p++) {
+                if (std::abs(palette[p] - (int)block[i].a) < std::abs(palette[bestIndex] - (int)block[i].a)) bestIndex = p;
+            }
+            packedIndices |= (std::uint64_t)bestIndex << (i*3);
+        }
+    }
+
+    out[0] = alpha0;
+    out[1] = alpha1;
+    for (int i=0; i<6; i++) out[2 + i] = (packedIndices >> (i*8)) & 0xff;
+}
+
+static void decodeAlphaBlock(const std::uint8_t* in, DecodedBlock& texels) {
+    const std::array<int, 8> palette = getAlphaPalette(in[0], in[1]);
+
+    std::uint64_t packedIndices = 0;
+    for (int i=0; i<6; i++) packedIndices |= (std::uint64_t)in[2 + i] << (i*8);
+
+    for (int i=0; i<16; i++) {
+        texels[i][3] = palette[(packedIndices >> (i*3)) & 7];
+    }
+}
+
+// BC7 mode 6: 7 bit RGBA endpoints with a shared lowest bit each, 4 bit indices
+
+static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// BC7 blocks are little endian bit streams
+class BitWriter {
+private:
+    std::uint8_t* out;
+    std::size_t   position = 0;
+public:
+    BitWriter(std::uint8_t* _out): out(_out) {}
+
+    void write(std::uint32_t value, int bitCount) {
+        for (int i=0; i<bitCount; i++, position++) {
+            if ((value >> i) & 1) out[position >> 3] |= 1 << (position & 7);
+        }
+    }
+};
+
+class BitReader {
+private:
+    const std::uint8_t* in;
+    std::size_t         position = 0;
+public:
+    BitReader(const std::uint8_t* _in): in(_in) {}
+
+    std::uint32_t read(int bitCount) {
+        std::uint32_t value = 0;
+        for (int i=0; i<bitCount; i++, position++) {
+            value |= (std::uint32_t)((in[position >> 3] >> (position & 7)) & 1) << i;
+        }
+        return value;
+    }
+};
+
+struct BC7Endpoint {
+    glm::ivec4 value; // 7 bits per channel
+    int        pBit;
+
+    glm::vec4 expand() const {
+        return glm::vec4(value * 2 + pBit);
+    }
+};
+
+// Closest 7 bit + shared p-bit representation of endpoint
+static BC7Endpoint quantizeBC7Endpoint(glm::vec4 endpoint) {
+    BC7Endpoint best = {};
+    float bestError = INFINITY;
+
+    for (int pBit=0; pBit<2; pBit++) {
+        BC7Endpoint candidate;
+        candidate.pBit  = pBit;
+        candidate.value = glm::clamp(glm::ivec4(glm::round((endpoint - (float)pBit) / 2.f)), glm::ivec4(0), glm::ivec4(127));
+
+        const float error = distanceSquared(candidate.expand(), endpoint, glm::vec4(1));
+        if (error < bestError) {
+            bestError = error;
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+static std::array<glm::vec4, 16> getBC7Palette(const BC7Endpoint& endpoint0, const BC7Endpoint& endpoint1) {
+    const glm::ivec4 e0 = glm::ivec4(endpoint0.expand());
+    const glm::ivec4 e1 = glm::ivec4(endpoint1.expand());
+
+    std::array<glm::vec4, 16> palette;
+    for (int i=0; i<16; i++) {
+        palette[i] = glm::vec4(((64 - bc7Weights[i]) * e0 + bc7Weights[i] * e1 + 32) >> 6);
+    }
+    return palette;
+}
+
+static void encodeBC7Block(const Block& block, std::uint8_t* out) {
+    const glm::vec4 rgba(1);
+
+    glm::vec4 a, b;
+    fitEndpoints(block, rgba, a, b);
+
+    BC7Endpoint  bestEndpoint0 = {}, bestEndpoint1 = {};
+    std::uint8_t bestIndices[16] = {};
+    float        bestError = INFINITY;
+
+    for (int iteration=0; iteration<2; iteration++) {
+        const BC7Endpoint endpoint0 = quantizeBC7Endpoint(a);
+        const BC7Endpoint endpoint1 = quantizeBC7Endpoint(b);
+
+        std::uint8_t indices[16];
+        const float error = selectIndices<16>(block, getBC7Palette(endpoint0, endpoint1), rgba, indices);
+
+        if (error < bestError) {
+            bestError     = error;
+            bestEndpoint0 = endpoint0;
+            bestEndpoint1 = endpoint1;
+            std::memcpy(bestIndices, indices, 16);
+        }
+
+        float weights[16];
+        for (int i=0; i<16; i++) weights[i] = bc7Weights[indices[i]] / 64.f;
+
+        a = endpoint0.expand();
+        b = endpoint1.expand();
+        refineEndpoints(block, weights, rgba, a, b);
+    }
+
+    // The first index is stored without its highest bit, swapping the endpoints mirrors the weights
+    if (bestIndices[0] >= 8) {
+        std::swap(bestEndpoint0, bestEndpoint1);
+        for (auto& index : bestIndices) index = 15 - index;
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer(out);
+
+    writer.write(1 << 6, 7);
+
+    for (int channel=0; channel<4; channel++) {
+        writer.write(bestEndpoint0.value[channel], 7);
+        writer.write(bestEndpoint1.value[channel], 7);
+    }
+
+    writer.write(bestEndpoint0.pBit, 1);
+    writer.write(bestEndpoint1.pBit, 1);
+
+    writer.write(bestIndices[0], 3);
+    for (int i=1; i<16; i++) writer.write(bestIndices[i], 4);
+}
+
+static void decodeBC7Block(const std::uint8_t* in, DecodedBlock& texels) {
+    BitReader reader(in);
+
+    // Other modes are never written by compressImage
+    if (reader.read(7) != (1 << 6)) {
+        texels.fill({ 255, 0, 255, 255 });
+        return;
+    }
+
+    BC7Endpoint endpoint0, endpoint1;
+    for (int channel=0; channel<4; channel++) {
+        endpoint0.value[channel] = reader.read(7);
+        endpoint1.value[channel] = reader.read(7);
+    }
+
+    endpoint0.pBit = reader.read(1);
+    endpoint1.pBit = reader.read(1);
+
+    const std::array<glm::vec4, 16> palette = getBC7Palette(endpoint0, endpoint1);
+
+    for (int i=0; i<16; i++) {
+        const glm::vec4& color = palette[reader.read(i == 0 ? 3 : 4)];
+        texels[i] = { (std::uint8_t)color.r, (std::uint8_t)color.g, (std::uint8_t)color.b, (std::uint8_t)color.a };
+    }
+}
+
+std::vector<std::uint8_t> compressImage(const Image& image, BlockFormat format) {
+    const std::size_t blocksWide = (image.width + 3) / 4;
+    const std::size_t blocksHigh = (image.height + 3) / 4;
+    const std::size_t blockBytes = getBlockBytes(format);
+
+    std::vector<std::uint8_t> blocks(blocksWide * blocksHigh * blockBytes);
+
+    for (std::size_t blockY=0; blockY<blocksHigh; blockY++) {
+        for (std::size_t blockX=0; blockX<blocksWide; blockX++) {
+            const Block block = readBlock(image, blockX, blockY);
+            std::uint8_t* out = &blocks[(blockY*blocksWide + blockX) * blockBytes];
+
+            switch (format) {
+                case BlockFormat::BC1:
+                    encodeColorBlock(block, out);
+                    break;
+                case BlockFormat::BC3:
+                    encodeAlphaBlock(block, out);
+                    encodeColorBlock(block, out + 8);
+                    break;
+                case BlockFormat::BC7:
+                    encodeBC7Block(block, out);
+                    break;
+            }
+        }
+    }
+
+    return blocks;
+}
+
+Image decompressImage(const std::uint8_t* blocks, std::size_t width, std::size_t height, BlockFormat format) {
+    const std::size_t blocksWide = (width + 3) / 4;
+    const std::size_t blocksHigh = (height + 3) / 4;
+    const std::size_t blockBytes = getBlockBytes(format);
+
+    Image image;
+    image.width  = width;
+    image.height = height;
+    image.pixels.resize(image.getByteSize());
+
+    for (std::size_t blockY=0; blockY<blocksHigh; blockY++) {
+        for (std::size_t blockX=0; blockX<blocksWide; blockX++) {
+            const std::uint8_t* in = &blocks[(blockY*blocksWide + blockX) * blockBytes];
+            DecodedBlock texels;
+
+            switch (format) {
+                case BlockFormat::BC1:
+                    decodeColorBlock(in, texels, false);
+                    break;
+                case BlockFormat::BC3:
+                    decodeColorBlock(in + 8, texels, true);
+                    decodeAlphaBlock(in, texels);
+                    break;
+                case BlockFormat::BC7:
+                    decodeBC7Block(in, texels);
+                    break;
+            }
+
+            // Texels past the edge of partial blocks are dropped
+            for (std::size_t y=0; y<4 && blockY*4 + y < height; y++) {
+                for (std::size_t x=0; x<4 && blockX*4 + x < width; x++) {
+                    std::memcpy(&image.pixels[((blockY*4 + y)*width + blockX*4 + x) * 4], texels[y*4 + x].data(), 4);
+                }
+            }
+        }
+    }
+
+    return image;
+}
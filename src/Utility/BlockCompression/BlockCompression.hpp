@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Utility/Image/Image.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// GPU block compressed formats, every 4x4 texel block is stored in a fixed number of bytes
+enum class BlockFormat : std::uint32_t {
+    BC1, // RGB, 8 bytes per block, alpha is dropped
+    BC3, // RGBA, 16 bytes per block, BC1 color with separately interpolated alpha
+    BC7, // RGBA, 16 bytes per block, higher quality than BC1/BC3
+};
+
+const char* getBlockFormatName(BlockFormat format);
+
+std::size_t getBlockBytes(BlockFormat format);
+
+// Bytes a width x height level takes up, partial blocks at the edges count as whole blocks
+std::size_t getCompressedSize(BlockFormat format, std::size_t width, std::size_t height);
+
+// Encode an RGBA8 image block by block. Texels past the edge of partial blocks repeat the edge.
+// BC7 is written in mode 6 only (one RGBA endpoint pair, 4 bit indices), which handles photos well
+// and keeps the encoder fast.
+std::vector<std::uint8_t> compressImage(const Image& image, BlockFormat format);
+
+// Decode blocks back into RGBA8, for drivers without the format.
+// The BC7 decoder only understands mode 6, so it reads what compressImage writes.
+Image decompressImage(const std::uint8_t* blocks, std::size_t width, std::size_t height, BlockFormat format);
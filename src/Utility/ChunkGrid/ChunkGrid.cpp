@@ -0,0 +1,107 @@
+#include "ChunkGrid.hpp"
+
+#include "Utility/FrustumCulling/FrustumCulling.hpp"
+
+#include <iostream>
+#include <algorithm>
+
+ChunkGrid::ChunkGrid(std::span<const glm::vec3> positions, float _chunkSize, float instanceRadius): chunkSize(_chunkSize) {
+    if (positions.empty()) return;
+
+    glm::vec3 boundsMin = positions[0];
+    glm::vec3 boundsMax = positions[0];
+    for (const glm::vec3& position : positions) {
+        boundsMin = glm::min(boundsMin, position);
+        boundsMax = glm::max(boundsMax, position);
+    }
+
+    // Dividing by a size that is not positive (or NaN) would ask for an endless grid
+    if (!(chunkSize > 0.f)) {
+        std::cout << "ChunkGrid: chunk size " << chunkSize << " is not positive, putting every instance into one chunk\n";
+        chunkSize = std::max(boundsMax.x - boundsMin.x, boundsMax.z - boundsMin.z) + 1.f;
+    }
+
+    const std::size_t columns = (std::size_t)((boundsMax.x - boundsMin.x) / chunkSize) + 1;
+    const std::size_t rows    = (std::size_t)((boundsMax.z - boundsMin.z) / chunkSize) + 1;
+
+    auto getCell = [&](const glm::vec3& position) {
+        const std::size_t column = std::min((std::size_t)((position.x - boundsMin.x) / chunkSize), columns - 1);
+        const std::size_t row    = std::min((std::size_t)((position.z - boundsMin.z) / chunkSize), rows - 1);
+        return row * columns + column;
+    };
+
+    // Counting sort by cell, stable so instances keep their relative order inside a chunk
+    std::vector<std::uint32_t> cellStarts(columns * rows + 1, 0);
+    for (const glm::vec3& position : positions) cellStarts[getCell(position) + 1]++;
+    for (std::size_t cell=0; cell<columns * rows; cell++) cellStarts[cell + 1] += cellStarts[cell];
+
+    order.resize(positions.size());
+    std::vector<std::uint32_t> cellEnds(cellStarts.begin(), cellStarts.end() - 1);
+    for (std::size_t i=0; i<positions.size(); i++) order[cellEnds[getCell(positions[i])]++] = i;
+
+    for (std::size_t cell=0; cell<columns * rows; cell++) {
+        const std::uint32_t first = cellStarts[cell];
+        const std::uint32_t count = cellStarts[cell + 1] - first;
+        if (count == 0) continue;
+
+        InstanceChunk chunk = { positions[order[first]], positions[order[first]], first, count };
+        for (std::uint32_t i=first; i<first + count; i++) {
+            chunk.boundsMin = glm::min(chunk.boundsMin, positions[order[i]]);
+            chunk.boundsMax = glm::max(chunk.boundsMax, positions[order[i]]);
+        }
+
+        chunk.boundsMin -= glm::vec3(instanceRadius);
+        chunk.boundsMax += glm::vec3(instanceRadius);
+
+        chunks.push_back(chunk);
+
+        minX.push_back(chunk.boundsMin.x); maxX.push_back(chunk.boundsMax.x);
+        minY.push_back(chunk.boundsMin.y); maxY.push_back(chunk.boundsMax.y);
+        minZ.push_back(chunk.boundsMin.z); maxZ.push_back(chunk.boundsMax.z);
+    }
+
+    visibleChunks.resize(chunks.size());
+}
+
+const std::vector<std::uint32_t>& ChunkGrid::getOrder() const {
+    return order;
+}
+
+const std::vector<InstanceChunk>& ChunkGrid::getChunks() const {
+    return chunks;
+}
+
+float ChunkGrid::getChunkSize() const {
+    return chunkSize;
+}
+
+void ChunkGrid::cull(const Frustum& frustum, std::vector<InstanceRange>& ranges) {
+    ranges.clear();
+
+    const AABBArrays bounds = { minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() };
+    const std::size_t visibleCount = cullAABBs(frustum, bounds, 0, chunks.size(), visibleChunks.data());
+
+    lastVisibleInstanceCount = 0;
+
+    for (std::size_t i=0; i<visibleCount; i++) {
+        const InstanceChunk& chunk = chunks[visibleChunks[i]];
+        lastVisibleInstanceCount += chunk.count;
+
+        // Chunks are stored back to back, so a visible neighbour just extends the range
+        if (!ranges.empty() && ranges.back().first + ranges.back().count == chunk.first) {
+            ranges.back().count += chunk.count;
+        } else {
+            ranges.push_back({ chunk.first, chunk.count });
+        }
+    }
+
+    lastVisibleChunkCount = visibleCount;
+}
+
+std::size_t ChunkGrid::getLastVisibleChunkCount() const {
+    return lastVisibleChunkCount;
+}
+
+std::size_t ChunkGrid::getLastVisibleInstanceCount() const {
+    return lastVisibleInstanceCount;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Utility/Frustum/Frustum.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// Instances bucketed into one square cell of a ChunkGrid, stored at first .. first + count - 1 of the reordered instances
+struct InstanceChunk {
+    glm::vec3     boundsMin;
+    glm::vec3     boundsMax;
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+// Contiguous run of instances to draw, neighbouring visible chunks merged
+struct InstanceRange {
+    std::uint32_t first;
+    std::uint32_t count;
+};
+
+// Static instances bucketed into square chunks on the XZ plane, so culling tests a few thousand chunk bounds
+// instead of every instance, and the visible ones come out as a handful of contiguous ranges to draw.
+//
+// The grid decides the order the instances have to be stored in: chunk by chunk, rows of chunks along X first, so
+// the visible chunks of a row are neighbours in the instance buffer too. getOrder() maps that order to the
+// original indices, reorder the instance data with it once.
+class ChunkGrid {
+private:
+    float chunkSize;
+
+    std::vector<InstanceChunk> chunks;
+    std::vector<std::uint32_t> order;
+
+    // Chunk bounds as separate arrays for cullAABBs
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+
+    std::vector<std::uint32_t> visibleChunks;
+    std::size_t lastVisibleChunkCount = 0;
+    std::size_t lastVisibleInstanceCount = 0;
+public:
+    // Chunks are chunkSize x chunkSize world units, empty ones are left out.
+    // The bounds are grown by instanceRadius, the reach of an instance around its position.
+    // A chunkSize that is not positive is reported and everything goes into a single chunk.
+    ChunkGrid(std::span<const glm::vec3> positions, float chunkSize, float instanceRadius);
+
+    // Original index of every instance, in the order they have to be stored in
+    const std::vector<std::uint32_t>& getOrder() const;
+    const std::vector<InstanceChunk>& getChunks() const;
+    float getChunkSize() const;
+
+    // Cull the chunks against frustum and write the instances of the visible ones to ranges, fewest ranges possible
+    void cull(const Frustum& frustum, std::vector<InstanceRange>& ranges);
+
+    // Of the last cull()
+    std::size_t getLastVisibleChunkCount() const;
+    std::size_t getLastVisibleInstanceCount() const;
+
+    // Copy data (one element per instance, in original order) into the order of the grid
+    template <typename T>
+    std::vector<T> reorder(std::span<const T> data) const {
+        std::vector<T> result;
+        result.reserve(order.size());
+
+        for (std::uint32_t index : order) result.push_back(data[index]);
+        return result;
+    }
+};
@@ -0,0 +1,100 @@
+#include "FileWatcher.hpp"
+
+#include <iostream>
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(std::string directory): rootDirectory(directory) {
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        std::cout << "FileWatcher: inotify unavailable, not watching " << directory << '\n';
+        return;
+    }
+
+    // inotify is not recursive, every subdirectory needs its own watch
+    watchDirectory(directory);
+
+    std::error_code error;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (entry.is_directory()) watchDirectory(entry.path().string());
+    }
+
+    running = true;
+    watchThread = std::thread(&FileWatcher::watchLoop, this);
+#else
+    std::cout << "FileWatcher: not supported on this platform, not watching " << directory << '\n';
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+    running = false;
+    if (watchThread.joinable()) watchThread.join();
+
+#ifdef __linux__
+    if (inotifyFd >= 0) close(inotifyFd);
+#endif
+}
+
+void FileWatcher::watchDirectory(const std::string& directory) {
+#ifdef __linux__
+    int watch = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watch >= 0) watchedDirectories[watch] = directory;
+#endif
+}
+
+void FileWatcher::watchLoop() {
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+
+    while (running) {
+        // Wake up regularly to notice the destructor asking us to stop
+        pollfd descriptor = { inotifyFd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 100) <= 0) continue;
+
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) continue;
+
+        for (char* ptr = buffer; ptr < buffer + length;) {
+            const inotify_event* event = (const inotify_event*)ptr;
+            ptr += sizeof(inotify_event) + event->len;
+
+            if (event->len == 0 || watchedDirectories.count(event->wd) == 0) continue;
+
+            std::filesystem::path path = std::filesystem::path(watchedDirectories[event->wd]) / event->name;
+
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) watchDirectory(path.string());
+                continue;
+            }
+
+            // Files are reported once they are closed, a bare create is not a finished write
+            if (event->mask & IN_CREATE) continue;
+
+            std::error_code error;
+            std::string canonicalPath = std::filesystem::weakly_canonical(path, error).string();
+
+            std::lock_guard lock(changedFilesMutex);
+            changedFiles.insert(canonicalPath);
+        }
+    }
+#endif
+}
+
+std::vector<std::string> FileWatcher::takeChangedFiles() {
+    std::lock_guard lock(changedFilesMutex);
+
+    std::vector<std::string> files(changedFiles.begin(), changedFiles.end());
+    changedFiles.clear();
+
+    return files;
+}
+
+bool FileWatcher::isWatching() const {
+    return running;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Watches a directory tree on a background thread and collects the files written in it.
+// Uses inotify, on other platforms nothing is ever reported.
+class FileWatcher {
+private:
+    std::string rootDirectory;
+
+    int inotifyFd = -1;
+    std::map<int, std::string> watchedDirectories; // watch descriptor -> directory
+
+    std::thread       watchThread;
+    std::atomic<bool> running = false;
+
+    std::mutex            changedFilesMutex;
+    std::set<std::string> changedFiles;
+
+    void watchDirectory(const std::string& directory);
+    void watchLoop();
+public:
+    FileWatcher(const FileWatcher&) = delete; // non construction-copyable
+    FileWatcher& operator=(const FileWatcher&) = delete; // non copyable
+
+    FileWatcher(std::string directory);
+    ~FileWatcher();
+
+    // Canonical paths of the files written since the last call
+    std::vector<std::string> takeChangedFiles();
+
+    bool isWatching() const;
+};
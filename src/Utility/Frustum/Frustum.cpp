@@ -0,0 +1,43 @@
+#include "Frustum.hpp"
+
+Frustum Frustum::fromViewProjection(const glm::mat4& viewProjection) {
+    // glm is column major, so rows are gathered across the columns
+    auto row = [&](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    Frustum frustum;
+    frustum.planes[Left]   = row(3) + row(0);
+    frustum.planes[Right]  = row(3) - row(0);
+    frustum.planes[Bottom] = row(3) + row(1);
+    frustum.planes[Top]    = row(3) - row(1);
+    frustum.planes[Near]   = row(3) + row(2);
+    frustum.planes[Far]    = row(3) - row(2);
+
+    for (glm::vec4& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return frustum;
+}
+
+bool Frustum::intersectsSphere(glm::vec3 center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsAABB(glm::vec3 min, glm::vec3 max) const {
+    for (const glm::vec4& plane : planes) {
+        // Corner furthest along the plane normal, if that one is outside the whole box is
+        const glm::vec3 corner(
+            plane.x >= 0 ? max.x : min.x,
+            plane.y >= 0 ? max.y : min.y,
+            plane.z >= 0 ? max.z : min.z
+        );
+
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0) return false;
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+// The six planes bounding what a camera sees, pointing inwards and normalized,
+// so dot(plane.xyz, point) + plane.w is the signed distance of point to the plane.
+struct Frustum {
+    enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    std::array<glm::vec4, PlaneCount> planes;
+
+    // Planes of the clip space volume of viewProjection (projection * view), in world space (Gribb/Hartmann)
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+    // Conservative, anything touching the frustum counts as inside
+    bool intersectsSphere(glm::vec3 center, float radius) const;
+    bool intersectsAABB(glm::vec3 min, glm::vec3 max) const;
+};
@@ -0,0 +1,269 @@
+#include "FrustumCulling.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FRUSTUM_CULLING_X86
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// The AVX2 kernels are compiled for AVX2 on their own, the rest of the program keeps running on any x86 CPU
+#if defined(__GNUC__)
+#define CULLING_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CULLING_TARGET_AVX2
+#endif
+
+const char* getCullingPathName(CullingPath path) {
+    switch (path) {
+        case CullingPath::Scalar: return "scalar";
+        case CullingPath::SSE:    return "SSE";
+        case CullingPath::AVX2:   return "AVX2";
+    }
+    return "unknown";
+}
+
+static bool detectAVX2() {
+#if defined(FRUSTUM_CULLING_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(FRUSTUM_CULLING_X86) && defined(_MSC_VER)
+    int info[4];
+
+    // The OS has to save the AVX registers too
+    __cpuid(info, 1);
+    const bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+    const bool hasAVX     = (info[2] & (1 << 28)) != 0;
+    if (!hasOSXSave || !hasAVX || (_xgetbv(0) & 6) != 6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool isCullingPathSupported(CullingPath path) {
+    static const bool hasAVX2 = detectAVX2();
+
+    switch (path) {
+        case CullingPath::Scalar: return true;
+#if defined(FRUSTUM_CULLING_X86)
+        case CullingPath::SSE:    return true; // SSE2 is part of every x86-64 CPU
+        case CullingPath::AVX2:   return hasAVX2;
+#endif
+        default:                  return false;
+    }
+}
+
+CullingPath getBestCullingPath() {
+    static const CullingPath bestPath =
+        isCullingPathSupported(CullingPath::AVX2) ? CullingPath::AVX2 :
+        isCullingPathSupported(CullingPath::SSE)  ? CullingPath::SSE  :
+                                                    CullingPath::Scalar;
+    return bestPath;
+}
+
+// The scalar kernels double as reference and as tail of the wide ones
+
+static std::size_t cullSpheresScalar(const Frustum& frustum, const SphereArrays& spheres, std::size_t begin, std::size_t end, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+
+    for (std::size_t i=begin; i<end; i++) {
+        const float radius = spheres.radius ? spheres.radius[i] : spheres.uniformRadius;
+
+        visibleIndices[visibleCount] = i;
+        visibleCount += frustum.intersectsSphere(glm::vec3(spheres.x[i], spheres.y[i], spheres.z[i]), radius);
+    }
+
+    return visibleCount;
+}
+
+static std::size_t cullAABBsScalar(const Frustum& frustum, const AABBArrays& boxes, std::size_t begin, std::size_t end, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+
+    for (std::size_t i=begin; i<end; i++) {
+        visibleIndices[visibleCount] = i;
+        visibleCount += frustum.intersectsAABB(
+            glm::vec3(boxes.minX[i], boxes.minY[i], boxes.minZ[i]),
+            glm::vec3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i])
+        );
+    }
+
+    return visibleCount;
+}
+
+// Box corner furthest along each plane normal, picked once per plane instead of per box
+struct PlaneCorner {
+    const float* x;
+    const float* y;
+    const float* z;
+};
+
+static void getPlaneCorners(const Frustum& frustum, const AABBArrays& boxes, PlaneCorner* corners) {
+    for (int p=0; p<Frustum::PlaneCount; p++) {
+        const glm::vec4& plane = frustum.planes[p];
+
+        corners[p] = {
+            plane.x >= 0 ? boxes.maxX : boxes.minX,
+            plane.y >= 0 ? boxes.maxY : boxes.minY,
+            plane.z >= 0 ? boxes.maxZ : boxes.minZ,
+        };
+    }
+}
+
+// Append the lanes set in visibleMask without branching on them. The slot written for a lane
+// that is not visible gets overwritten by the next one, and never lies past the lane's own index.
+static inline std::size_t appendVisible(std::uint32_t* visibleIndices, std::size_t visibleCount, std::size_t base, int laneCount, int visibleMask) {
+    for (int lane=0; lane<laneCount; lane++) {
+        visibleIndices[visibleCount] = base + lane;
+        visibleCount += (visibleMask >> lane) & 1;
+    }
+    return visibleCount;
+}
+
+#if defined(FRUSTUM_CULLING_X86)
+
+// Same operation order as the scalar reference, ((nx*x + ny*y) + nz*z) + w, so results match bit for bit
+
+static std::size_t cullSpheresSSE(const Frustum& frustum, const SphereArrays& spheres, std::size_t begin, std::size_t end, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+    std::size_t i = begin;
+
+    for (; i + 4 <= end; i += 4) {
+        const __m128 x = _mm_loadu_ps(spheres.x + i);
+        const __m128 y = _mm_loadu_ps(spheres.y + i);
+        const __m128 z = _mm_loadu_ps(spheres.z + i);
+        const __m128 radius = spheres.radius ? _mm_loadu_ps(spheres.radius + i) : _mm_set1_ps(spheres.uniformRadius);
+        const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+        __m128 outside = _mm_setzero_ps();
+
+        for (const glm::vec4& plane : frustum.planes) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+        }
+
+        visibleCount = appendVisible(visibleIndices, visibleCount, i, 4, ~_mm_movemask_ps(outside) & 0xF);
+    }
+
+    return visibleCount + cullSpheresScalar(frustum, spheres, i, end, visibleIndices + visibleCount);
+}
+
+static std::size_t cullAABBsSSE(const Frustum& frustum, const AABBArrays& boxes, std::size_t begin, std::size_t end, std::uint32_t* visibleIndices) {
+    PlaneCorner corners[Frustum::PlaneCount];
+    getPlaneCorners(frustum, boxes, corners);
+
+    std::size_t visibleCount = 0;
+    std::size_t i = begin;
+
+    for (; i + 4 <= end; i += 4) {
+        __m128 outside = _mm_setzero_ps();
+
+        for (int p=0; p<Frustum::PlaneCount; p++) {
+            const glm::vec4& plane = frustum.planes[p];
+
+            __m128 distance = _mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(plane.x), _mm_loadu_ps(corners[p].x + i)),
+                _mm_mul_ps(_mm_set1_ps(plane.y), _mm_loadu_ps(corners[p].y + i))
+            );
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), _mm_loadu_ps(corners[p].z + i)));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+        }
+
+        visibleCount = appendVisible(visibleIndices, visibleCount, i, 4, ~_mm_movemask_ps(outside) & 0xF);
+    }
+
+    return visibleCount + cullAABBsScalar(frustum, boxes, i, end, visibleIndices + visibleCount);
+}
+
+CULLING_TARGET_AVX2
+static std::size_t cullSpheresAVX2(const Frustum& frustum, const SphereArrays& spheres, std::size_t begin, std::size_t end, std::uint32_t* visibleIndices) {
+    std::size_t visibleCount = 0;
+    std::size_t i = begin;
+
+    for (; i + 8 <= end; i += 8) {
+        const __m256 x = _mm256_loadu_ps(spheres.x + i);
+        const __m256 y = _mm256_loadu_ps(spheres.y + i);
+        const __m256 z = _mm256_loadu_ps(spheres.z + i);
+        const __m256 radius = spheres.radius ? _mm256_loadu_ps(spheres.radius + i) : _mm256_set1_ps(spheres.uniformRadius);
+        const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), radius);
+
+        __m256 outside = _mm256_setzero_ps();
+
+        for (const glm::vec4& plane : frustum.planes) {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x), _mm256_mul_ps(_mm256_set1_ps(plane.y), y));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.z), z));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negativeRadius, _CMP_LT_OQ));
+        }
+
+        visibleCount = appendVisible(visibleIndices, visibleCount, i, 8, ~_mm256_movemask_ps(outside) & 0xFF);
+    }
+
+    return visibleCount + cullSpheresScalar(frustum, spheres, i, end, visibleIndices + visibleCount);
+}
+
+CULLING_TARGET_AVX2
+static std::size_t cullAABBsAVX2(const Frustum& frustum, const AABBArrays& boxes, std::size_t begin, std::size_t end, std::uint32_t* visibleIndices) {
+    PlaneCorner corners[Frustum::PlaneCount];
+    getPlaneCorners(frustum, boxes, corners);
+
+    std::size_t visibleCount = 0;
+    std::size_t i = begin;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 outside = _mm256_setzero_ps();
+
+        for (int p=0; p<Frustum::PlaneCount; p++) {
+            const glm::vec4& plane = frustum.planes[p];
+
+            __m256 distance = _mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(plane.x), _mm256_loadu_ps(corners[p].x + i)),
+                _mm256_mul_ps(_mm256_set1_ps(plane.y), _mm256_loadu_ps(corners[p].y + i))
+            );
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.z), _mm256_loadu_ps(corners[p].z + i)));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+
+        visibleCount = appendVisible(visibleIndices, visibleCount, i, 8, ~_mm256_movemask_ps(outside) & 0xFF);
+    }
+
+    return visibleCount + cullAABBsScalar(frustum, boxes, i, end, visibleIndices + visibleCount);
+}
+
+#endif
+
+std::size_t cullSpheres(const Frustum& frustum, const SphereArrays& spheres, std::size_t first, std::size_t count, std::uint32_t* visibleIndices, CullingPath path) {
+    if (!isCullingPathSupported(path)) path = getBestCullingPath();
+
+    switch (path) {
+#if defined(FRUSTUM_CULLING_X86)
+        case CullingPath::AVX2: return cullSpheresAVX2(frustum, spheres, first, first + count, visibleIndices);
+        case CullingPath::SSE:  return cullSpheresSSE(frustum, spheres, first, first + count, visibleIndices);
+#endif
+        default:                return cullSpheresScalar(frustum, spheres, first, first + count, visibleIndices);
+    }
+}
+
+std::size_t cullAABBs(const Frustum& frustum, const AABBArrays& boxes, std::size_t first, std::size_t count, std::uint32_t* visibleIndices, CullingPath path) {
+    if (!isCullingPathSupported(path)) path = getBestCullingPath();
+
+    switch (path) {
+#if defined(FRUSTUM_CULLING_X86)
+        case CullingPath::AVX2: return cullAABBsAVX2(frustum, boxes, first, first + count, visibleIndices);
+        case CullingPath::SSE:  return cullAABBsSSE(frustum, boxes, first, first + count, visibleIndices);
+#endif
+        default:                return cullAABBsScalar(frustum, boxes, first, first + count, visibleIndices);
+    }
+}
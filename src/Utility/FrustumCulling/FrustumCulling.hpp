@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Utility/Frustum/Frustum.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+// Bounding spheres as separate arrays (structure of arrays), so 8 of them load into one AVX register
+struct SphereArrays {
+    const float* x;
+    const float* y;
+    const float* z;
+
+    // nullptr when every sphere has uniformRadius
+    const float* radius = nullptr;
+    float        uniformRadius = 0;
+};
+
+struct AABBArrays {
+    const float* minX;
+    const float* minY;
+    const float* minZ;
+    const float* maxX;
+    const float* maxY;
+    const float* maxZ;
+};
+
+// Instruction sets the culling kernels come in
+enum class CullingPath {
+    Scalar,
+    SSE,  // 4 at a time
+    AVX2, // 8 at a time
+};
+
+const char* getCullingPathName(CullingPath path);
+
+// Fastest path the CPU runs, detected once
+CullingPath getBestCullingPath();
+bool isCullingPathSupported(CullingPath path);
+
+// Test elements first to first + count - 1 against frustum and write the indices of those touching it to
+// visibleIndices in ascending order, which needs room for count indices. Returns how many were written.
+// Every path gives exactly the same result as Frustum::intersectsSphere / intersectsAABB.
+std::size_t cullSpheres(const Frustum& frustum, const SphereArrays& spheres, std::size_t first, std::size_t count, std::uint32_t* visibleIndices, CullingPath path = getBestCullingPath());
+std::size_t cullAABBs(const Frustum& frustum, const AABBArrays& boxes, std::size_t first, std::size_t count, std::uint32_t* visibleIndices, CullingPath path = getBestCullingPath());
@@ -2,7 +2,11 @@
 
 #include "glad/glad.h"
 
+#include "Utility/GL/GLObjectCounter/GLObjectCounter.hpp"
+
 #include <span>
+#include <vector>
+#include <algorithm>
 
 
 template <typename T>
@@ -12,21 +16,144 @@ private:
     bool   ready = false;
 
     std::size_t lastBufferedCount = 0;
+    std::size_t bufferCapacity = 0;
+
+    // CPU copy of elements written through update(), only allocated once update() is used.
+    // Elements outside of the dirty ranges are never read, so it does not need to mirror the GPU copy.
+    std::vector<T> shadow;
+
+    struct DirtyRange {
+        std::size_t begin;
+        std::size_t end;
+    };
+    std::vector<DirtyRange> dirtyRanges;
+
+    std::size_t lastFlushedCount = 0;
+
+    // Reallocate the GL store to at least newCapacity elements (growing geometrically), keeping the
+    // first keepCount elements. The buffer name stays the same so vertex array bindings stay valid.
+    void grow(std::size_t newCapacity, std::size_t keepCount) {
+        newCapacity = std::max(newCapacity, bufferCapacity + bufferCapacity / 2);
+
+        GLuint tempBuffer = 0;
+        if (keepCount > 0) {
+            glGenBuffers(1, &tempBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, tempBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, sizeof(T)*keepCount, nullptr, GL_STREAM_COPY);
+
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(T)*keepCount);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(T)*newCapacity, nullptr, GL_DYNAMIC_DRAW);
+
+        if (keepCount > 0) {
+            glBindBuffer(GL_COPY_READ_BUFFER, tempBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(T)*keepCount);
+
+            glDeleteBuffers(1, &tempBuffer);
+        }
+
+        bufferCapacity = newCapacity;
+    }
 public:
     Buffer() {
         glGenBuffers(1, &buffer);
+        GLObjectCounter::bufferCreated();
     }
-    
+
     ~Buffer() {
         glDeleteBuffers(1, &buffer);
+        GLObjectCounter::bufferDeleted();
     }
 
 
-    void bufferData(std::span<T> data) {
+    // Replace the whole contents. Only reallocates the GL store when the data does not fit the current capacity.
+    void bufferData(std::span<const T> data) {
+        if (data.size() > bufferCapacity) {
+            grow(data.size(), 0);
+        }
+
         glBindBuffer(GL_ARRAY_BUFFER, buffer);
-	    glBufferData(GL_ARRAY_BUFFER, sizeof(T)*data.size(), data.data(), GL_STATIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(T)*data.size(), data.data());
 
         lastBufferedCount = data.size();
+        dirtyRanges.clear();
+    }
+
+    // Resize to count elements without uploading anything, the new contents are undefined until written
+    void allocate(std::size_t count) {
+        if (count > bufferCapacity) grow(count, 0);
+        lastBufferedCount = count;
+        dirtyRanges.clear();
+    }
+
+    // Make sure the buffer can hold count elements without reallocating
+    void reserve(std::size_t count) {
+        if (count > bufferCapacity) grow(count, lastBufferedCount);
+    }
+
+    // Overwrite elements starting at offset. The write is recorded and sent to the GPU on the next flush().
+    // Writing past the end grows the buffer.
+    void update(std::size_t offset, std::span<const T> data) {
+        if (data.empty()) return;
+
+        const std::size_t end = offset + data.size();
+
+        if (end > bufferCapacity) {
+            grow(end, lastBufferedCount);
+        }
+        lastBufferedCount = std::max(lastBufferedCount, end);
+
+        if (shadow.size() < lastBufferedCount) shadow.resize(lastBufferedCount);
+        std::copy(data.begin(), data.end(), shadow.begin() + offset);
+
+        dirtyRanges.push_back({ offset, end });
+    }
+
+    // Upload every range written through update() since the last flush. Overlapping and adjacent
+    // ranges are merged first so each contiguous run is sent with a single glBufferSubData.
+    // Call once per frame before drawing.
+    void flush() {
+        lastFlushedCount = 0;
+        if (dirtyRanges.empty()) return;
+
+        std::sort(dirtyRanges.begin(), dirtyRanges.end(), [](const DirtyRange& a, const DirtyRange& b) {
+            return a.begin < b.begin;
+        });
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        DirtyRange current = dirtyRanges[0];
+        auto upload = [&](const DirtyRange& range) {
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(T)*range.begin, sizeof(T)*(range.end - range.begin), &shadow[range.begin]);
+            lastFlushedCount += range.end - range.begin;
+        };
+
+        for (std::size_t i=1; i<dirtyRanges.size(); i++) {
+            const DirtyRange& next = dirtyRanges[i];
+
+            if (next.begin <= current.end) {
+                current.end = std::max(current.end, next.end);
+            } else {
+                upload(current);
+                current = next;
+            }
+        }
+        upload(current);
+
+        dirtyRanges.clear();
+    }
+
+    bool isDirty() const {
+        return !dirtyRanges.empty();
+    }
+
+    // Number of elements uploaded by the last flush()
+    std::size_t getLastFlushedCount() const {
+        return lastFlushedCount;
     }
 
     GLuint getBufferId() {
@@ -36,4 +163,8 @@ public:
     std::size_t size() const {
         return lastBufferedCount;
     }
-};
\ No newline at end of file
+
+    std::size_t capacity() const {
+        return bufferCapacity;
+    }
+};
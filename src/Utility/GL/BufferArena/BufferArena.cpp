@@ -0,0 +1,91 @@
+#include "BufferArena.hpp"
+
+#include "Utility/GL/GLObjectCounter/GLObjectCounter.hpp"
+
+#include <iostream>
+
+BufferArena::BufferArena(GLsizeiptr size):
+    arenaSize(size)
+{
+    glGenBuffers(1, &buffer);
+    GLObjectCounter::bufferCreated();
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, arenaSize, nullptr, GL_STATIC_DRAW);
+
+    freeBlocks.insert({ 0, arenaSize });
+}
+
+BufferArena::~BufferArena() {
+    glDeleteBuffers(1, &buffer);
+    GLObjectCounter::bufferDeleted();
+}
+
+BufferArena::Allocation BufferArena::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    if (size == 0) return { 0, 0 };
+
+    for (auto it = freeBlocks.begin(); it != freeBlocks.end(); it++) {
+        GLintptr   blockOffset = it->first;
+        GLsizeiptr blockSize   = it->second;
+
+        GLintptr alignedOffset = (blockOffset + alignment - 1) / alignment * alignment;
+        GLsizeiptr padding = alignedOffset - blockOffset;
+
+        if (blockSize < padding + size) continue;
+
+        freeBlocks.erase(it);
+
+        // Give the alignment padding and the tail back to the free list
+        if (padding > 0) freeBlocks.insert({ blockOffset, padding });
+
+        GLsizeiptr tail = blockSize - padding - size;
+        if (tail > 0) freeBlocks.insert({ alignedOffset + size, tail });
+
+        usedBytes += size;
+        return { alignedOffset, size };
+    }
+
+    std::cout << "BufferArena out of memory! (" << size << " bytes requested, " << usedBytes << "/" << arenaSize << " used)\n";
+    std::exit(1);
+}
+
+void BufferArena::free(Allocation allocation) {
+    if (allocation.size == 0) return;
+
+    usedBytes -= allocation.size;
+
+    auto it = freeBlocks.insert({ allocation.offset, allocation.size }).first;
+
+    // Merge with the following block
+    auto next = std::next(it);
+    if (next != freeBlocks.end() && it->first + it->second == next->first) {
+        it->second += next->second;
+        freeBlocks.erase(next);
+    }
+
+    // Merge with the preceding block
+    if (it != freeBlocks.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == it->first) {
+            prev->second += it->second;
+            freeBlocks.erase(it);
+        }
+    }
+}
+
+void BufferArena::upload(const Allocation& allocation, const void* data, GLsizeiptr size) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, allocation.offset, size, data);
+}
+
+GLuint BufferArena::getBufferId() {
+    return buffer;
+}
+
+GLsizeiptr BufferArena::getUsedBytes() const {
+    return usedBytes;
+}
+
+GLsizeiptr BufferArena::getSize() const {
+    return arenaSize;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Utility/Utility.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <typeindex>
+
+template <typename T>
+class ArenaBuffer;
+
+// One large GL buffer that many small buffers are suballocated from.
+// Allocations are handed out with a first-fit free list that merges neighbouring free blocks on release.
+// Must be created through std::make_shared since handles keep the arena alive.
+class BufferArena : public std::enable_shared_from_this<BufferArena> {
+public:
+    struct Allocation {
+        GLintptr   offset;
+        GLsizeiptr size;
+    };
+private:
+    GLuint     buffer;
+    GLsizeiptr arenaSize;
+    GLsizeiptr usedBytes = 0;
+
+    // Free blocks keyed by offset
+    std::map<GLintptr, GLsizeiptr> freeBlocks;
+
+    // Static allocations deduplicated by content, keyed by content hash
+    struct StaticEntry {
+        std::type_index        type;
+        std::vector<std::byte> contents;
+        std::weak_ptr<void>    handle;
+    };
+    std::unordered_multimap<std::uint64_t, StaticEntry> staticEntries;
+
+public:
+    BufferArena(const BufferArena&) = delete; // non construction-copyable
+    BufferArena& operator=(const BufferArena&) = delete; // non copyable
+
+    BufferArena(GLsizeiptr size);
+    ~BufferArena();
+
+    Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+    void free(Allocation allocation);
+
+    void upload(const Allocation& allocation, const void* data, GLsizeiptr size);
+
+    // Allocate and upload count elements of T, the allocation is released with the returned handle
+    template <typename T>
+    std::shared_ptr<ArenaBuffer<T>> createBuffer(std::span<const T> data) {
+        auto handle = std::make_shared<ArenaBuffer<T>>(shared_from_this(), data.size());
+        upload(handle->getAllocation(), data.data(), sizeof(T)*data.size());
+        return handle;
+    }
+
+    // Like createBuffer, but identical contents share one allocation.
+    // Use for static geometry that is never written after creation.
+    template <typename T>
+    std::shared_ptr<ArenaBuffer<T>> createStatic(std::span<const T> data) {
+        auto bytes = std::as_bytes(data);
+        std::uint64_t hash = hashBytes(bytes.data(), bytes.size());
+
+        auto [begin, end] = staticEntries.equal_range(hash);
+        for (auto it = begin; it != end;) {
+            auto handle = it->second.handle.lock();
+
+            if (handle == nullptr) {
+                it = staticEntries.erase(it);
+                continue;
+            }
+
+            if (it->second.type == std::type_index(typeid(T)) && it->second.contents.size() == bytes.size() && std::memcmp(it->second.contents.data(), bytes.data(), bytes.size()) == 0) {
+                return std::static_pointer_cast<ArenaBuffer<T>>(handle);
+            }
+
+            it++;
+        }
+
+        auto handle = createBuffer(data);
+        staticEntries.insert({ hash, StaticEntry{ std::type_index(typeid(T)), std::vector<std::byte>(bytes.begin(), bytes.end()), handle } });
+
+        return handle;
+    }
+
+    GLuint getBufferId();
+
+    GLsizeiptr getUsedBytes() const;
+    GLsizeiptr getSize() const;
+};
+
+// Typed handle to a range inside a BufferArena, frees its range when destroyed
+template <typename T>
+class ArenaBuffer {
+private:
+    std::shared_ptr<BufferArena> arena;
+    BufferArena::Allocation      allocation;
+    std::size_t                  count;
+public:
+    ArenaBuffer(const ArenaBuffer&) = delete; // non construction-copyable
+    ArenaBuffer& operator=(const ArenaBuffer&) = delete; // non copyable
+
+    ArenaBuffer(std::shared_ptr<BufferArena> _arena, std::size_t _count):
+        arena(_arena),
+        allocation(_arena->allocate(sizeof(T)*_count)),
+        count(_count) {}
+
+    ~ArenaBuffer() {
+        arena->free(allocation);
+    }
+
+    void bufferData(std::span<const T> data, std::size_t offset = 0) {
+        BufferArena::Allocation range = { allocation.offset + (GLintptr)(sizeof(T)*offset), (GLsizeiptr)(sizeof(T)*data.size()) };
+        arena->upload(range, data.data(), range.size);
+    }
+
+    GLuint getBufferId() {
+        return arena->getBufferId();
+    }
+
+    // Byte offset of the first element inside the arena buffer
+    GLintptr getOffset() const {
+        return allocation.offset;
+    }
+
+    const BufferArena::Allocation& getAllocation() const {
+        return allocation;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+
+// A shader compiled into the executable, path is relative to the shader directory
+struct EmbeddedShaderFile {
+    std::string_view path;
+    std::string_view source;
+};
+
+// Defined in the EmbeddedShaders.cpp that cmake/EmbedShaders.cmake generates at build time.
+// Empty when building with SHADERS_FROM_DISK.
+std::span<const EmbeddedShaderFile> getEmbeddedShaderFiles();
@@ -0,0 +1,37 @@
+#include "FrameUniforms.hpp"
+
+#include "Camera/CameraController/CameraController.hpp"
+
+#include <algorithm>
+
+FrameUniforms::FrameUniforms() {
+    uniformBuffer.bufferData(std::span<const FrameUniformData>(&data, 1));
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, uniformBuffer.getBufferId());
+}
+
+FrameUniforms::~FrameUniforms() {}
+
+void FrameUniforms::setFog(glm::vec3 color, float start, float end) {
+    data.fogColor  = glm::vec4(color, 1);
+    data.fogParams = glm::vec4(start, end, 0, 0);
+}
+
+void FrameUniforms::update(const CameraController& cameraController, const glm::mat4& projectionMatrix, double time, double deltaTime) {
+    data.viewMatrix     = cameraController.getViewMatrix();
+    data.viewProjection = projectionMatrix * data.viewMatrix;
+    data.cameraPosition = glm::vec4(cameraController.getPosition(), 1);
+    data.time           = glm::vec4((float)time, (float)deltaTime, 0, 0);
+
+    // Built once here instead of by every shader invocation that culls
+    const Frustum frustum = Frustum::fromViewProjection(data.viewProjection);
+    std::copy(frustum.planes.begin(), frustum.planes.end(), data.frustumPlanes);
+
+    uniformBuffer.bufferData(std::span<const FrameUniformData>(&data, 1));
+
+    // Other code may bind its own buffers to the binding point
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, uniformBuffer.getBufferId());
+}
+
+const FrameUniformData& FrameUniforms::getData() const {
+    return data;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Utility/GL/Buffer/Buffer.hpp"
+#include "Utility/Frustum/Frustum.hpp"
+
+#include <glm/glm.hpp>
+
+class CameraController;
+
+// CPU side of the FrameUniforms block in the shaders, laid out as std140
+struct FrameUniformData {
+    glm::mat4 viewMatrix;
+    glm::mat4 viewProjection;
+    glm::vec4 cameraPosition;
+    glm::vec4 fogColor;
+    glm::vec4 fogParams;  // x = fog start distance, y = fog end distance
+    glm::vec4 time;       // x = seconds since start, y = frame delta in seconds
+    glm::vec4 frustumPlanes[Frustum::PlaneCount]; // Frustum::planes of viewProjection
+};
+
+static_assert(sizeof(FrameUniformData) == 288, "FrameUniformData must match the std140 layout of the FrameUniforms block");
+
+// Per frame state every program reads: camera, frustum, fog and time.
+// Uploaded once per frame into a uniform buffer bound to a fixed binding point, every
+// ShaderProgram with a FrameUniforms block gets linked to that binding point.
+class FrameUniforms {
+private:
+    Buffer<FrameUniformData> uniformBuffer;
+    FrameUniformData         data = { };
+public:
+    static constexpr GLuint      bindingPoint = 0;
+    static constexpr const char* blockName    = "FrameUniforms";
+
+    FrameUniforms(const FrameUniforms&) = delete; // non construction-copyable
+    FrameUniforms& operator=(const FrameUniforms&) = delete; // non copyable
+
+    FrameUniforms();
+    ~FrameUniforms();
+
+    void setFog(glm::vec3 color, float start, float end);
+
+    // Fill in the camera and time and upload the block
+    void update(const CameraController& cameraController, const glm::mat4& projectionMatrix, double time, double deltaTime);
+
+    const FrameUniformData& getData() const;
+};
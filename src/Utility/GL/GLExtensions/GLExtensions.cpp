@@ -0,0 +1,21 @@
+#include "GLExtensions.hpp"
+
+#include <set>
+
+bool hasGLExtension(const std::string& name) {
+    // The extension list never changes for a context, so only ask once
+    static std::set<std::string> extensions;
+    static bool queried = false;
+
+    if (!queried) {
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+        for (GLint i=0; i<extensionCount; i++) {
+            extensions.insert((const char*)glGetStringi(GL_EXTENSIONS, i));
+        }
+        queried = true;
+    }
+
+    return extensions.count(name) != 0;
+}
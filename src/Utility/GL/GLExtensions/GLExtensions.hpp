@@ -0,0 +1,9 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <string>
+
+// glad is generated without extensions, so extensions are looked up by name at runtime.
+// Needs a current context.
+bool hasGLExtension(const std::string& name);
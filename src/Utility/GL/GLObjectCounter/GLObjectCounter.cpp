@@ -0,0 +1,15 @@
+#include "GLObjectCounter.hpp"
+
+std::atomic<int> GLObjectCounter::liveBuffers = 0;
+
+void GLObjectCounter::bufferCreated() {
+    liveBuffers++;
+}
+
+void GLObjectCounter::bufferDeleted() {
+    liveBuffers--;
+}
+
+int GLObjectCounter::getLiveBufferCount() {
+    return liveBuffers;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <atomic>
+
+// Counts live GL objects so we can see how many of them a scene creates
+class GLObjectCounter {
+private:
+    static std::atomic<int> liveBuffers;
+public:
+    static void bufferCreated();
+    static void bufferDeleted();
+
+    static int getLiveBufferCount();
+};
@@ -0,0 +1,34 @@
+#include "GpuQuery.hpp"
+
+GpuQuery::GpuQuery(GLenum _target): target(_target) {
+    glGenQueries(QueryCount, queries);
+}
+
+GpuQuery::~GpuQuery() {
+    glDeleteQueries(QueryCount, queries);
+}
+
+void GpuQuery::begin() {
+    // Pick up the result of the query we are about to reuse if the GPU is done with it
+    if (issued[current]) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[current], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available == GL_TRUE) {
+            glGetQueryObjectui64v(queries[current], GL_QUERY_RESULT, &lastResult);
+        }
+    }
+
+    glBeginQuery(target, queries[current]);
+}
+
+void GpuQuery::end() {
+    glEndQuery(target);
+
+    issued[current] = true;
+    current = (current + 1) % QueryCount;
+}
+
+GLuint64 GpuQuery::getLastResult() const {
+    return lastResult;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "glad/glad.h"
+
+// Query around the commands issued between begin() and end(), e.g. GL_TIME_ELAPSED or GL_SAMPLES_PASSED.
+// Queries are recycled in a ring and only read once their result is available, so measuring never stalls the pipeline.
+class GpuQuery {
+private:
+    static constexpr int QueryCount = 4;
+
+    GLenum target;
+
+    GLuint queries[QueryCount];
+    bool   issued[QueryCount] = { };
+    int    current = 0;
+
+    GLuint64 lastResult = 0;
+public:
+    GpuQuery(const GpuQuery&) = delete; // non construction-copyable
+    GpuQuery& operator=(const GpuQuery&) = delete; // non copyable
+
+    GpuQuery(GLenum target);
+    ~GpuQuery();
+
+    void begin();
+    void end();
+
+    // Most recent finished result, usually a few frames old
+    GLuint64 getLastResult() const;
+};
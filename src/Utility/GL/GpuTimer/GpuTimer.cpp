@@ -0,0 +1,7 @@
+#include "GpuTimer.hpp"
+
+GpuTimer::GpuTimer(): GpuQuery(GL_TIME_ELAPSED) {}
+
+double GpuTimer::getLastResultMs() const {
+    return getLastResult() / 1e6;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Utility/GL/GpuQuery/GpuQuery.hpp"
+
+// Measures how long the GPU spends on the commands issued between begin() and end(), without stalling
+class GpuTimer : public GpuQuery {
+public:
+    GpuTimer();
+
+    // Most recent finished measurement, usually a few frames old
+    double getLastResultMs() const;
+};
@@ -0,0 +1,95 @@
+#include "HeadlessContext.hpp"
+
+#include <iostream>
+
+#ifdef HAS_EGL
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+HeadlessContext::HeadlessContext(std::size_t width, std::size_t height) {
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay == nullptr) {
+        std::cout << "HeadlessContext: eglGetPlatformDisplayEXT is not available\n";
+        return;
+    }
+
+    EGLDisplay eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+    EGLint major, minor;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cout << "HeadlessContext: no surfaceless EGL display (0x" << std::hex << eglGetError() << std::dec << ")\n";
+        return;
+    }
+    display = eglDisplay;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "HeadlessContext: EGL can not create OpenGL contexts\n";
+        return;
+    }
+
+    // GL 4.5 for the compute and indirect paths, 4.1 is the least the renderer runs on
+    for (EGLint minorVersion : { 5, 1 }) {
+        const EGLint attributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION,       4,
+            EGL_CONTEXT_MINOR_VERSION,       minorVersion,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+            EGL_NONE
+        };
+
+        EGLContext eglContext = eglCreateContext(eglDisplay, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+        if (eglContext != EGL_NO_CONTEXT) {
+            context = eglContext;
+            break;
+        }
+    }
+
+    if (context == nullptr) {
+        std::cout << "HeadlessContext: failed to create a GL 4.1+ context (0x" << std::hex << eglGetError() << std::dec << ")\n";
+        return;
+    }
+
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)context) || !gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        std::cout << "HeadlessContext: failed to make the context current\n";
+        eglDestroyContext(eglDisplay, (EGLContext)context);
+        context = nullptr;
+        return;
+    }
+
+    // Draws and glClear need a complete framebuffer
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+
+    glViewport(0, 0, width, height);
+}
+
+HeadlessContext::~HeadlessContext() {
+    if (context != nullptr) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &renderbuffer);
+
+        eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+    }
+
+    if (display != nullptr) eglTerminate((EGLDisplay)display);
+}
+
+#else
+
+HeadlessContext::HeadlessContext(std::size_t, std::size_t) {
+    std::cout << "HeadlessContext: built without EGL\n";
+}
+
+HeadlessContext::~HeadlessContext() {}
+
+#endif
+
+bool HeadlessContext::isValid() const {
+    return context != nullptr;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+// An OpenGL context without any window or display, for benchmarks on machines without one (CI, Mesa llvmpipe).
+// Created through surfaceless EGL (EGL_MESA_platform_surfaceless) and made current on construction. Such a
+// context has no default framebuffer, so a width x height RGBA8 framebuffer object is bound in its place.
+//
+// Only available when built with EGL (HAS_EGL, see src/CMakeLists.txt), otherwise isValid() is always false.
+class HeadlessContext {
+private:
+    void* display = nullptr;
+    void* context = nullptr;
+
+    GLuint framebuffer  = 0;
+    GLuint renderbuffer = 0;
+public:
+    HeadlessContext(const HeadlessContext&) = delete; // non construction-copyable
+    HeadlessContext& operator=(const HeadlessContext&) = delete; // non copyable
+
+    // Asks for a GL 4.5 compatibility context and falls back to 4.1, prints the reason when both fail
+    HeadlessContext(std::size_t width, std::size_t height);
+    ~HeadlessContext();
+
+    // A context is current and glad is loaded
+    bool isValid() const;
+};
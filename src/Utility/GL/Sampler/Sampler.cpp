@@ -0,0 +1,90 @@
+#include "Sampler.hpp"
+
+#include "Utility/GL/GLExtensions/GLExtensions.hpp"
+
+#include <algorithm>
+
+std::map<SamplerDescription, std::weak_ptr<Sampler>> Sampler::samplers;
+
+SamplerDescription SamplerDescription::nearest() {
+    SamplerDescription description;
+    description.minFilter = GL_NEAREST;
+    description.magFilter = GL_NEAREST;
+    return description;
+}
+
+SamplerDescription SamplerDescription::bilinear() {
+    SamplerDescription description;
+    description.minFilter = GL_LINEAR;
+    description.magFilter = GL_LINEAR;
+    return description;
+}
+
+SamplerDescription SamplerDescription::trilinear() {
+    return SamplerDescription();
+}
+
+SamplerDescription SamplerDescription::anisotropic(float maxAnisotropy) {
+    SamplerDescription description;
+    description.maxAnisotropy = maxAnisotropy;
+    return description;
+}
+
+Sampler::Sampler(const SamplerDescription& _description): description(_description) {
+    glGenSamplers(1, &sampler);
+
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, description.minFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, description.magFilter);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, description.wrapS);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, description.wrapT);
+
+    float anisotropy = std::min(description.maxAnisotropy, getMaxSupportedAnisotropy());
+    if (anisotropy > 1.f) {
+        glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, anisotropy);
+    }
+}
+
+Sampler::~Sampler() {
+    glDeleteSamplers(1, &sampler);
+}
+
+std::shared_ptr<Sampler> Sampler::get(const SamplerDescription& description) {
+    auto it = samplers.find(description);
+    if (it != samplers.end()) {
+        if (auto sampler = it->second.lock()) return sampler;
+    }
+
+    auto sampler = std::make_shared<Sampler>(description);
+    samplers[description] = sampler;
+
+    return sampler;
+}
+
+void Sampler::bind(GLuint textureUnit) {
+    glBindSampler(textureUnit, sampler);
+}
+
+void Sampler::unbind(GLuint textureUnit) {
+    glBindSampler(textureUnit, 0);
+}
+
+GLuint Sampler::getSamplerId() {
+    return sampler;
+}
+
+const SamplerDescription& Sampler::getDescription() const {
+    return description;
+}
+
+float Sampler::getMaxSupportedAnisotropy() {
+    // Core in 4.6, an extension everywhere else
+    static const bool supported = GLAD_GL_VERSION_4_6
+        || hasGLExtension("GL_ARB_texture_filter_anisotropic")
+        || hasGLExtension("GL_EXT_texture_filter_anisotropic");
+
+    if (!supported) return 1.f;
+
+    GLfloat maxAnisotropy = 1.f;
+    glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+    return maxAnisotropy;
+}
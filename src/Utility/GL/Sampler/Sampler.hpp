@@ -0,0 +1,54 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+struct SamplerDescription {
+    GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLenum magFilter = GL_LINEAR;
+    GLenum wrapS     = GL_REPEAT;
+    GLenum wrapT     = GL_REPEAT;
+
+    // 1 disables anisotropic filtering, clamped to what the driver supports
+    float maxAnisotropy = 1.f;
+
+    static SamplerDescription nearest();
+    static SamplerDescription bilinear();
+    static SamplerDescription trilinear();
+    static SamplerDescription anisotropic(float maxAnisotropy = 16.f);
+
+    bool operator<(const SamplerDescription& other) const {
+        return std::tie(minFilter, magFilter, wrapS, wrapT, maxAnisotropy) < std::tie(other.minFilter, other.magFilter, other.wrapS, other.wrapT, other.maxAnisotropy);
+    }
+};
+
+// Sampling state, bound to a texture unit next to the texture so one texture can be sampled in different ways.
+// Samplers are shared through get(), identical descriptions give the same GL object.
+class Sampler {
+private:
+    GLuint sampler;
+    SamplerDescription description;
+
+    static std::map<SamplerDescription, std::weak_ptr<Sampler>> samplers;
+public:
+    Sampler(const Sampler&) = delete; // non construction-copyable
+    Sampler& operator=(const Sampler&) = delete; // non copyable
+
+    Sampler(const SamplerDescription& description);
+    ~Sampler();
+
+    // Shared sampler for description, created on first use
+    static std::shared_ptr<Sampler> get(const SamplerDescription& description);
+
+    void bind(GLuint textureUnit);
+    static void unbind(GLuint textureUnit);
+
+    GLuint getSamplerId();
+    const SamplerDescription& getDescription() const;
+
+    // 1 when anisotropic filtering is not available
+    static float getMaxSupportedAnisotropy();
+};
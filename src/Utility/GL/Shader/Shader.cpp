@@ -3,10 +3,14 @@
 #include <vector>
 
 #include "Utility/Utility.hpp"
+#include "Utility/GL/ShaderPreprocessor/ShaderPreprocessor.hpp"
 
 Shader::Shader(Shader&& other) {
     shader = other.shader;
     initialized = other.initialized;
+    source = std::move(other.source);
+    sourcePath = std::move(other.sourcePath);
+    sourceFiles = std::move(other.sourceFiles);
     
     other.initialized = false;
 }
@@ -21,13 +25,21 @@ Shader::~Shader() {
         glDeleteShader(shader);
 }
 
-void Shader::addSourceCode(std::string code) {
-    const char* codeCStr = code.c_str();
+void Shader::setVariant(const ShaderVariant& variant) {
+    source = variant.code;
+    sourceFiles = variant.files;
+
+    const char* codeCStr = source.c_str();
     glShaderSource(shader, 1, &codeCStr, nullptr);
 }
 
-void Shader::addSourceCodeFromPath(std::string path) {
-    addSourceCode(loadFile(path));
+void Shader::addSourceCode(std::string code, const std::vector<std::string>& defines) {
+    setVariant(ShaderPreprocessor::preprocessSource(code, defines));
+}
+
+void Shader::addSourceCodeFromPath(std::string path, const std::vector<std::string>& defines) {
+    setVariant(ShaderPreprocessor::preprocessFile(path, defines));
+    sourcePath = path;
 }
 
 void Shader::compile() {
@@ -53,10 +65,33 @@ std::string Shader::getInfoLog() {
 
     std::vector<char> shaderLogBuffer(infoLogLength);
     glGetShaderInfoLog(shader, infoLogLength, nullptr, &shaderLogBuffer[0]);
-    
-    return std::string(shaderLogBuffer.begin(), shaderLogBuffer.end());
+
+    std::string log(shaderLogBuffer.begin(), shaderLogBuffer.end());
+
+    // Errors point at source string numbers, say which file is which
+    if (sourceFiles.size() > 1) {
+        std::string fileList;
+        for (std::size_t i=0; i<sourceFiles.size(); i++) {
+            fileList += "  " + std::to_string(i) + ": " + sourceFiles[i] + "\n";
+        }
+        log = "Source strings:\n" + fileList + log;
+    }
+
+    return log;
 }
 
 GLuint Shader::getShaderId() {
     return shader;
+}
+
+const std::string& Shader::getSourceCode() {
+    return source;
+}
+
+const std::string& Shader::getSourcePath() {
+    return sourcePath;
+}
+
+const std::vector<std::string>& Shader::getSourceFiles() {
+    return sourceFiles;
 }
\ No newline at end of file
@@ -3,12 +3,24 @@
 #include "glad/glad.h"
 
 #include <string>
+#include <vector>
+
+struct ShaderVariant;
 
 class Shader {
 private:
     GLuint shader;
     
     bool initialized = false;
+
+    // Kept around to key the program binary cache
+    std::string source;
+    std::string sourcePath;
+
+    // Main file and included files, see ShaderVariant
+    std::vector<std::string> sourceFiles;
+
+    void setVariant(const ShaderVariant& variant);
 public:
     Shader(const Shader&) = delete; // non construction-copyable
     Shader& operator=(const Shader&) = delete; // non copyable
@@ -18,8 +30,10 @@ public:
 
     ~Shader();
 
-    void addSourceCode(std::string code);
-    void addSourceCodeFromPath(std::string path);
+    // Sources go through the ShaderPreprocessor: #include is resolved and defines ("NAME" or "NAME value")
+    // are injected right after the #version line
+    void addSourceCode(std::string code, const std::vector<std::string>& defines = {});
+    void addSourceCodeFromPath(std::string path, const std::vector<std::string>& defines = {});
 
     void compile();
 
@@ -28,4 +42,8 @@ public:
     std::string getInfoLog();
 
     GLuint getShaderId();
+
+    const std::string& getSourceCode();
+    const std::string& getSourcePath();
+    const std::vector<std::string>& getSourceFiles();
 };
\ No newline at end of file
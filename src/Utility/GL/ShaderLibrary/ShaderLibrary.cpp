@@ -0,0 +1,147 @@
+#include "ShaderLibrary.hpp"
+
+#include "Utility/GL/GLExtensions/GLExtensions.hpp"
+#include "Utility/GL/ShaderPreprocessor/ShaderPreprocessor.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+std::string ShaderProgramDescription::getKey() const {
+    std::string key;
+
+    for (auto& stage : stages) {
+        key += std::to_string(stage.type) + ":" + stage.path + ";";
+    }
+
+    // Define order does not matter
+    std::vector<std::string> sortedDefines = defines;
+    std::sort(sortedDefines.begin(), sortedDefines.end());
+
+    key += "|";
+    for (auto& define : sortedDefines) {
+        key += define + ";";
+    }
+
+    // Capture order matters, it is the layout of the feedback buffer
+    key += "|";
+    for (auto& varying : feedbackVaryings) {
+        key += varying + ";";
+    }
+
+    return key;
+}
+
+ShaderLibrary::ShaderLibrary() {
+    const bool parallelCompile = hasGLExtension("GL_KHR_parallel_shader_compile") || hasGLExtension("GL_ARB_parallel_shader_compile");
+
+    if (parallelCompile) {
+        // Not part of the generated glad loader
+        using MaxShaderCompilerThreadsProc = void (APIENTRYP)(GLuint count);
+
+        auto maxShaderCompilerThreads = (MaxShaderCompilerThreadsProc)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        if (maxShaderCompilerThreads == nullptr) maxShaderCompilerThreads = (MaxShaderCompilerThreadsProc)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+
+        // Let the driver pick how many threads to use
+        if (maxShaderCompilerThreads != nullptr) maxShaderCompilerThreads(0xFFFFFFFF);
+    }
+
+    ShaderProgram::setParallelCompileSupported(parallelCompile);
+}
+
+ShaderLibrary::~ShaderLibrary() {}
+
+std::unique_ptr<ShaderProgram> ShaderLibrary::createProgram(const ShaderProgramDescription& description, std::set<std::string>& dependencies) {
+    auto program = std::make_unique<ShaderProgram>();
+    dependencies.clear();
+
+    for (auto& stage : description.stages) {
+        Shader shader(stage.type);
+        shader.addSourceCodeFromPath(stage.path, description.defines);
+
+        dependencies.insert(shader.getSourceFiles().begin(), shader.getSourceFiles().end());
+
+        program->addShader(std::move(shader));
+    }
+
+    program->setFeedbackVaryings(description.feedbackVaryings);
+    program->beginBuild();
+
+    return program;
+}
+
+std::shared_ptr<ShaderProgram> ShaderLibrary::request(const ShaderProgramDescription& description) {
+    std::string key = description.getKey();
+
+    auto it = programs.find(key);
+    if (it != programs.end()) return it->second.program;
+
+    Entry entry;
+    entry.description = description;
+    entry.program = createProgram(description, entry.dependencies);
+
+    auto program = entry.program;
+    programs.insert({ key, std::move(entry) });
+    return program;
+}
+
+void ShaderLibrary::finishAll() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    for (auto& [key, entry] : programs) {
+        auto& program = entry.program;
+        if (!program->isBuildPending()) continue;
+
+        if (!program->finishBuild()) {
+            std::cout << program->getBuildLog() << '\n';
+            std::exit(1);
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    printf("ShaderLibrary: %zu programs ready, waited %.2f ms\n", programs.size(), ms);
+}
+
+std::size_t ShaderLibrary::getProgramCount() const {
+    return programs.size();
+}
+
+void ShaderLibrary::enableHotReload(std::string directory) {
+    fileWatcher = std::make_unique<FileWatcher>(directory);
+}
+
+void ShaderLibrary::update() {
+    if (fileWatcher == nullptr) return;
+
+    // Start rebuilding everything that includes an edited file, a newer edit replaces a rebuild in flight
+    std::set<Entry*> editedEntries;
+
+    for (auto& path : fileWatcher->takeChangedFiles()) {
+        ShaderPreprocessor::invalidate(path);
+
+        for (auto& [key, entry] : programs) {
+            if (entry.dependencies.count(path) != 0) editedEntries.insert(&entry);
+        }
+    }
+
+    for (Entry* entry : editedEntries) {
+        std::cout << "Reloading program " << entry->description.getKey() << '\n';
+        entry->rebuild = createProgram(entry->description, entry->dependencies);
+    }
+
+    // Swap in rebuilds the driver finished
+    for (auto& [key, entry] : programs) {
+        if (entry.rebuild == nullptr || !entry.rebuild->isBuildComplete()) continue;
+
+        if (entry.rebuild->finishBuild()) {
+            entry.program->adoptProgram(*entry.rebuild);
+        } else {
+            std::cout << "Reload failed, keeping the old program:\n" << entry.rebuild->getBuildLog() << '\n';
+        }
+
+        entry.rebuild = nullptr;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Utility/GL/ShaderProgram/ShaderProgram.hpp"
+#include "Utility/FileWatcher/FileWatcher.hpp"
+
+#include <map>
+#include <set>
+#include <memory>
+#include <string>
+#include <vector>
+
+// What a program is built from. Two descriptions with the same stages and defines give the same program.
+// Defines select a specialized variant of the sources, see ShaderPreprocessor.
+struct ShaderProgramDescription {
+    struct Stage {
+        GLenum      type;
+        std::string path;
+    };
+
+    std::vector<Stage>       stages;
+    std::vector<std::string> defines;
+
+    // Outputs captured with transform feedback, see ShaderProgram::setFeedbackVaryings
+    std::vector<std::string> feedbackVaryings = {};
+
+    std::string getKey() const;
+};
+
+// Builds and owns every shader program of an app.
+//
+// request() only issues the compile and link commands and returns right away, so request every program
+// up front and let the driver compile them side by side (on several threads with GL_KHR_parallel_shader_compile).
+// Status is only queried when a program is first used, or all at once with finishAll().
+//
+// With hot reload enabled, programs whose sources change on disk are rebuilt in the background and
+// swapped in by update() once the build is done. A build that fails keeps the old program.
+class ShaderLibrary {
+private:
+    struct Entry {
+        ShaderProgramDescription       description;
+        std::shared_ptr<ShaderProgram> program;
+
+        // Rebuild with changed sources, swapped into program once it finished
+        std::unique_ptr<ShaderProgram> rebuild;
+
+        // Canonical paths of every file the sources include
+        std::set<std::string> dependencies;
+    };
+
+    std::map<std::string, Entry> programs;
+
+    std::unique_ptr<FileWatcher> fileWatcher;
+
+    static std::unique_ptr<ShaderProgram> createProgram(const ShaderProgramDescription& description, std::set<std::string>& dependencies);
+public:
+    ShaderLibrary(const ShaderLibrary&) = delete; // non construction-copyable
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete; // non copyable
+
+    ShaderLibrary();
+    ~ShaderLibrary();
+
+    // Returns the already requested program when an identical description was requested before
+    std::shared_ptr<ShaderProgram> request(const ShaderProgramDescription& description);
+
+    // Wait for every requested program, a program that fails to build is fatal
+    void finishAll();
+
+    std::size_t getProgramCount() const;
+
+    // Watch directory for shader edits
+    void enableHotReload(std::string directory = "./shader");
+
+    // Start rebuilds of edited programs and swap in the finished ones, call once per frame.
+    // Never waits for the driver when GL_KHR_parallel_shader_compile is available.
+    void update();
+};
@@ -0,0 +1,184 @@
+#include "ShaderPreprocessor.hpp"
+
+#include "Utility/Utility.hpp"
+#include "Utility/GL/EmbeddedShaders/EmbeddedShaders.hpp"
+
+#include <filesystem>
+#include <algorithm>
+#include <sstream>
+#include <regex>
+
+std::vector<std::string>             ShaderPreprocessor::includeDirectories = { "./shader/include" };
+std::map<std::string, std::string>   ShaderPreprocessor::fileCache;
+std::map<std::string, ShaderVariant> ShaderPreprocessor::variantCache;
+
+std::string                             ShaderPreprocessor::shaderDirectory = "./shader";
+std::map<std::string, std::string_view> ShaderPreprocessor::embeddedFiles;
+bool                                    ShaderPreprocessor::embeddedFilesLoaded = false;
+std::set<std::string>                   ShaderPreprocessor::editedFiles;
+
+void ShaderPreprocessor::addIncludeDirectory(std::string directory) {
+    includeDirectories.push_back(directory);
+}
+
+void ShaderPreprocessor::setShaderDirectory(std::string directory) {
+    shaderDirectory = directory;
+    embeddedFiles.clear();
+    embeddedFilesLoaded = false;
+}
+
+const std::map<std::string, std::string_view>& ShaderPreprocessor::getEmbeddedFiles() {
+    if (!embeddedFilesLoaded) {
+        for (auto& file : getEmbeddedShaderFiles()) {
+            embeddedFiles.insert({ canonicalPath(shaderDirectory + "/" + std::string(file.path)), file.source });
+        }
+        embeddedFilesLoaded = true;
+    }
+
+    return embeddedFiles;
+}
+
+bool ShaderPreprocessor::fileExists(const std::string& canonicalPath) {
+    if (getEmbeddedFiles().count(canonicalPath) != 0) return true;
+
+    std::error_code error;
+    return std::filesystem::is_regular_file(canonicalPath, error);
+}
+
+std::string ShaderPreprocessor::canonicalPath(const std::string& path) {
+    std::error_code error;
+    return std::filesystem::weakly_canonical(path, error).string();
+}
+
+const std::string& ShaderPreprocessor::readFile(const std::string& canonicalPath) {
+    auto it = fileCache.find(canonicalPath);
+    if (it != fileCache.end()) return it->second;
+
+    auto embedded = getEmbeddedFiles().find(canonicalPath);
+    if (embedded != getEmbeddedFiles().end() && editedFiles.count(canonicalPath) == 0) {
+        return fileCache.insert({ canonicalPath, std::string(embedded->second) }).first->second;
+    }
+
+    return fileCache.insert({ canonicalPath, loadFile(canonicalPath) }).first->second;
+}
+
+std::string ShaderPreprocessor::resolveInclude(const std::string& name, const std::string& includingDirectory) {
+    std::vector<std::string> searchDirectories;
+    if (!includingDirectory.empty()) searchDirectories.push_back(includingDirectory);
+    searchDirectories.insert(searchDirectories.end(), includeDirectories.begin(), includeDirectories.end());
+
+    for (auto& directory : searchDirectories) {
+        std::string candidate = canonicalPath((std::filesystem::path(directory) / name).string());
+        if (fileExists(candidate)) return candidate;
+    }
+
+    return "";
+}
+
+void ShaderPreprocessor::expand(const std::string& code, const std::string& directory, int fileIndex, const std::vector<std::string>& defines, ShaderVariant& variant) {
+    static const std::regex includePattern(R"(^\s*#\s*include\s*"([^"]+)\".*)");
+    static const std::regex versionPattern(R"(^\s*#\s*version\b.*)");
+
+    const bool isMainFile = fileIndex == 0;
+    bool definesInjected = !isMainFile || defines.empty();
+
+    // Without #version the defines go first, otherwise right after it
+    static const std::regex versionSearchPattern(R"((^|\n)\s*#\s*version\b)");
+    const bool hasVersion = std::regex_search(code, versionSearchPattern);
+
+    auto injectDefines = [&](int nextLine) {
+        for (auto& define : defines) {
+            variant.code += "#define " + define + "\n";
+        }
+        variant.code += "#line " + std::to_string(nextLine) + " " + std::to_string(fileIndex) + "\n";
+        definesInjected = true;
+    };
+
+    std::istringstream lines(code);
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        std::smatch match;
+
+        // #version has to stay the first statement
+        if (!definesInjected && std::regex_match(line, versionPattern)) {
+            variant.code += line + "\n";
+            injectDefines(lineNumber + 1);
+            continue;
+        }
+
+        if (!definesInjected && !hasVersion) injectDefines(lineNumber);
+
+        if (!std::regex_match(line, match, includePattern)) {
+            variant.code += line + "\n";
+            continue;
+        }
+
+        std::string includePath = resolveInclude(match[1].str(), directory);
+
+        if (includePath.empty()) {
+            // Let the driver report it like any other compile error
+            variant.code += "#error cannot find include \"" + match[1].str() + "\"\n";
+            continue;
+        }
+
+        // Include every file once
+        if (std::find(variant.files.begin(), variant.files.end(), includePath) != variant.files.end()) {
+            variant.code += "\n";
+            continue;
+        }
+
+        int includeIndex = variant.files.size();
+        variant.files.push_back(includePath);
+
+        variant.code += "#line 1 " + std::to_string(includeIndex) + "\n";
+        expand(readFile(includePath), std::filesystem::path(includePath).parent_path().string(), includeIndex, {}, variant);
+        variant.code += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+    }
+
+    if (!definesInjected) injectDefines(1);
+}
+
+std::string ShaderPreprocessor::getVariantKey(const std::string& canonicalPath, std::vector<std::string> defines) {
+    std::sort(defines.begin(), defines.end());
+
+    std::string key = canonicalPath + "|";
+    for (auto& define : defines) {
+        key += define + ";";
+    }
+    return key;
+}
+
+const ShaderVariant& ShaderPreprocessor::preprocessFile(const std::string& path, const std::vector<std::string>& defines) {
+    std::string mainPath = canonicalPath(path);
+    std::string key = getVariantKey(mainPath, defines);
+
+    auto it = variantCache.find(key);
+    if (it != variantCache.end()) return it->second;
+
+    ShaderVariant variant;
+    variant.files.push_back(mainPath);
+    expand(readFile(mainPath), std::filesystem::path(mainPath).parent_path().string(), 0, defines, variant);
+
+    return variantCache.insert({ key, std::move(variant) }).first->second;
+}
+
+ShaderVariant ShaderPreprocessor::preprocessSource(const std::string& code, const std::vector<std::string>& defines) {
+    ShaderVariant variant;
+    variant.files.push_back("");
+    expand(code, "", 0, defines, variant);
+
+    return variant;
+}
+
+void ShaderPreprocessor::invalidate(const std::string& canonicalPath) {
+    fileCache.erase(canonicalPath);
+    editedFiles.insert(canonicalPath);
+
+    std::erase_if(variantCache, [&](const auto& entry) {
+        const auto& files = entry.second.files;
+        return std::find(files.begin(), files.end(), canonicalPath) != files.end();
+    });
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shader source ready for glShaderSource, with everything it was built from
+struct ShaderVariant {
+    std::string code;
+
+    // Canonical paths of the main file and every included file. The index of a file is the
+    // source string number of its lines in #line directives, so driver errors like "1(12)" point into files[1].
+    std::vector<std::string> files;
+};
+
+// Resolves #include "file" (relative to the including file, then the include directories; every file is
+// included once) and injects #defines ("NAME" or "NAME value") right after #version.
+//
+// Files and variants are cached, a variant is keyed by its main file and its define set. Call invalidate()
+// when a file changes on disk to drop the file and every variant that included it.
+//
+// Files are read from the shaders embedded at build time when they are there, so startup does no file I/O.
+// Files missing from the executable and files invalidated after an edit are read from disk.
+class ShaderPreprocessor {
+private:
+    static std::vector<std::string> includeDirectories;
+
+    // Directory the embedded shader paths are relative to
+    static std::string shaderDirectory;
+
+    static std::map<std::string, std::string_view> embeddedFiles; // canonical path -> source
+    static bool                                    embeddedFilesLoaded;
+    static std::set<std::string>                   editedFiles;   // read from disk from now on
+
+    static const std::map<std::string, std::string_view>& getEmbeddedFiles();
+    static bool fileExists(const std::string& canonicalPath);
+
+    static std::map<std::string, std::string>   fileCache;    // canonical path -> contents
+    static std::map<std::string, ShaderVariant> variantCache; // variant key -> variant
+
+    static const std::string& readFile(const std::string& canonicalPath);
+    static std::string resolveInclude(const std::string& name, const std::string& includingDirectory);
+
+    static void expand(const std::string& code, const std::string& directory, int fileIndex, const std::vector<std::string>& defines, ShaderVariant& variant);
+public:
+    static void addIncludeDirectory(std::string directory);
+    static void setShaderDirectory(std::string directory);
+
+    static const ShaderVariant& preprocessFile(const std::string& path, const std::vector<std::string>& defines);
+
+    // For code that does not come from a file, includes are searched in the include directories only
+    static ShaderVariant preprocessSource(const std::string& code, const std::vector<std::string>& defines);
+
+    static void invalidate(const std::string& canonicalPath);
+
+    // Same key for the same file and the same defines in any order
+    static std::string getVariantKey(const std::string& canonicalPath, std::vector<std::string> defines);
+
+    static std::string canonicalPath(const std::string& path);
+};
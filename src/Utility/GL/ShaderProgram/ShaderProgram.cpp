@@ -1,5 +1,24 @@
 #include "ShaderProgram.hpp"
 
+#include "Utility/Utility.hpp"
+#include "Utility/GL/FrameUniforms/FrameUniforms.hpp"
+#include "Utility/GL/TextureAtlas/TextureAtlas.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+std::string ShaderProgram::binaryCacheDirectory = "./shadercache";
+ShaderProgram::UniformStats ShaderProgram::uniformStats;
+bool ShaderProgram::parallelCompileSupported = false;
+
 ShaderProgram::ShaderProgram() {
     program = glCreateProgram();
 }
@@ -16,11 +35,25 @@ std::vector<Shader>& ShaderProgram::getShaderList() {
     return shaders;
 }
 
+void ShaderProgram::setFeedbackVaryings(std::vector<std::string> varyings) {
+    feedbackVaryings = std::move(varyings);
+}
+
 void ShaderProgram::linkProgram() {
     for(auto& shader : shaders) {
         glAttachShader(program, shader.getShaderId());
     }
 
+    if (!feedbackVaryings.empty()) {
+        std::vector<const char*> names;
+        for (auto& varying : feedbackVaryings) names.push_back(varying.c_str());
+
+        glTransformFeedbackVaryings(program, names.size(), names.data(), GL_INTERLEAVED_ATTRIBS);
+    }
+
+    // Allow glGetProgramBinary for the binary cache
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glLinkProgram(program);
 
     for(auto& shader : shaders) {
@@ -28,6 +61,184 @@ void ShaderProgram::linkProgram() {
     }
 }
 
+std::string ShaderProgram::getBinaryCacheKey() {
+    // A binary is only valid for the driver that produced it
+    std::uint64_t hash = hashBytes(nullptr, 0);
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char* value = (const char*)glGetString(name);
+        if (value != nullptr) hash = hashBytes(value, std::strlen(value) + 1, hash);
+    }
+
+    for (auto& shader : shaders) {
+        GLenum type = shader.getShaderType();
+        hash = hashBytes(&type, sizeof(type), hash);
+
+        const std::string& source = shader.getSourceCode();
+        hash = hashBytes(source.data(), source.size() + 1, hash);
+    }
+
+    // The captured outputs are baked into the binary too
+    for (auto& varying : feedbackVaryings) {
+        hash = hashBytes(varying.data(), varying.size() + 1, hash);
+    }
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash);
+    return key;
+}
+
+bool ShaderProgram::loadProgramBinary(const std::string& key) {
+    std::ifstream file(binaryCacheDirectory + "/" + key + ".bin", std::ios::binary);
+    if (!file) return false;
+
+    GLenum format;
+    file.read((char*)&format, sizeof(format));
+    if (file.gcount() != sizeof(format)) return false;
+
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (binary.empty()) return false;
+
+    glProgramBinary(program, format, binary.data(), binary.size());
+
+    // The driver rejects binaries it can no longer use (driver update, different GPU, ...)
+    if (!isProgramLinked()) {
+        std::cout << "Stale program binary " << key << ", recompiling\n";
+        return false;
+    }
+
+    return true;
+}
+
+void ShaderProgram::saveProgramBinary(const std::string& key) {
+    GLint binaryLength = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0) return;
+
+    std::vector<char> binary(binaryLength);
+    GLenum format;
+    glGetProgramBinary(program, binaryLength, nullptr, &format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(binaryCacheDirectory, error);
+
+    // Written under a temporary name first, so a crash never leaves a truncated binary behind under the real one
+    const std::string cachePath = binaryCacheDirectory + "/" + key + ".bin";
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        file.write((const char*)&format, sizeof(format));
+        file.write(binary.data(), binary.size());
+
+        if (!file) return;
+    }
+
+    std::filesystem::rename(temporaryPath, cachePath, error);
+}
+
+bool ShaderProgram::build() {
+    beginBuild();
+    return finishBuild();
+}
+
+void ShaderProgram::beginBuild() {
+    buildStartTime = std::chrono::steady_clock::now();
+    buildPending = true;
+    loadedFromBinary = false;
+
+    // Drivers without any binary format can not cache
+    GLint binaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+    const bool useCache = !binaryCacheDirectory.empty() && binaryFormatCount > 0;
+    binaryCacheKey = useCache ? getBinaryCacheKey() : "";
+
+    if (useCache && loadProgramBinary(binaryCacheKey)) {
+        loadedFromBinary = true;
+        return;
+    }
+
+    // No status queries in between, those would make us wait for each compile in turn
+    for (auto& shader : shaders) {
+        shader.compile();
+    }
+
+    linkProgram();
+}
+
+bool ShaderProgram::finishBuild() {
+    if (!buildPending) return isProgramLinked();
+    buildPending = false;
+
+    std::string sourcePaths;
+    for (auto& shader : shaders) {
+        if (!sourcePaths.empty()) sourcePaths += ", ";
+        sourcePaths += shader.getSourcePath();
+    }
+
+    auto reportTime = [&](const char* what) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStartTime).count();
+        printf("Program [%s] %s in %.2f ms\n", sourcePaths.c_str(), what, ms);
+    };
+
+    if (loadedFromBinary) {
+        reflectUniforms();
+        bindUniformBlocks();
+
+        reportTime("loaded from binary cache (warm)");
+        shaders.clear();
+        return true;
+    }
+
+    if (!isProgramLinked()) {
+        // Point at the failing stage if there is one, otherwise it is a link error
+        for (auto& shader : shaders) {
+            if (!shader.isShaderCompiled()) {
+                buildLog = shader.getSourcePath() + ":\n" + shader.getInfoLog();
+                return false;
+            }
+        }
+
+        buildLog = getInfoLog();
+        return false;
+    }
+
+    if (!binaryCacheKey.empty()) saveProgramBinary(binaryCacheKey);
+
+    reflectUniforms();
+    bindUniformBlocks();
+
+    reportTime("compiled (cold)");
+
+    // Shaders are not needed anymore after linking the program
+    shaders.clear();
+    return true;
+}
+
+bool ShaderProgram::isBuildComplete() {
+    if (!buildPending || loadedFromBinary || !parallelCompileSupported) return true;
+
+    GLint complete = GL_TRUE;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+bool ShaderProgram::isBuildPending() {
+    return buildPending;
+}
+
+void ShaderProgram::ensureBuilt() {
+    if (!buildPending) return;
+
+    if (!finishBuild()) {
+        std::cout << buildLog << '\n';
+        std::exit(1);
+    }
+}
+
+std::string ShaderProgram::getBuildLog() {
+    return buildLog;
+}
+
 bool ShaderProgram::isProgramLinked() {
     GLint value;
     glGetProgramiv(program, GL_LINK_STATUS, &value);
@@ -45,9 +256,229 @@ std::string ShaderProgram::getInfoLog() {
 }
 
 void ShaderProgram::use() {
+    ensureBuilt();
     glUseProgram(program);
 }
 
-GLuint ShaderProgram::getUniformLocation(std::string location) {
-    return glGetUniformLocation(program, location.c_str());
-}
\ No newline at end of file
+GLuint ShaderProgram::getUniformLocation(const std::string& name) {
+    UniformHandle handle = getUniformHandle(name);
+    if (handle >= 0) return uniforms[handle].location;
+
+    // Not in the table, e.g. an array element other than the first
+    return glGetUniformLocation(program, name.c_str());
+}
+
+// Bytes of one value of a uniform type
+static std::size_t uniformTypeSize(GLenum type) {
+    switch (type) {
+        case GL_FLOAT:        return sizeof(float);
+        case GL_FLOAT_VEC2:   return sizeof(glm::vec2);
+        case GL_FLOAT_VEC3:   return sizeof(glm::vec3);
+        case GL_FLOAT_VEC4:   return sizeof(glm::vec4);
+        case GL_INT_VEC2:     return sizeof(glm::ivec2);
+        case GL_INT_VEC3:     return sizeof(glm::ivec3);
+        case GL_INT_VEC4:     return sizeof(glm::ivec4);
+        case GL_FLOAT_MAT3:   return sizeof(glm::mat3);
+        case GL_FLOAT_MAT4:   return sizeof(glm::mat4);
+        default:              return sizeof(glm::mat4); // Scalars, bools, samplers and anything else fit in here
+    }
+}
+
+void ShaderProgram::reflectUniforms() {
+    uniforms.clear();
+    uniformHandles.clear();
+    uniformValues.clear();
+
+    GLint uniformCount = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<char> nameBuffer(maxNameLength + 1);
+
+    for (GLint i=0; i<uniformCount; i++) {
+        GLsizei nameLength = 0;
+        GLint   arraySize = 0;
+        GLenum  type = 0;
+        glGetActiveUniform(program, i, nameBuffer.size(), &nameLength, &arraySize, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), nameLength);
+
+        // Uniform block members have no location
+        GLint location = glGetUniformLocation(program, name.c_str());
+        if (location < 0) continue;
+
+        // Arrays are reported as "name[0]", look them up by "name"
+        if (name.size() > 3 && name.ends_with("[0]")) name.resize(name.size() - 3);
+
+        UniformInfo info;
+        info.name        = name;
+        info.location    = location;
+        info.type        = type;
+        info.arraySize   = arraySize;
+        info.valueOffset = uniformValues.size();
+        info.valueSize   = uniformTypeSize(type);
+
+        uniformValues.resize(uniformValues.size() + info.valueSize);
+
+        uniformHandles.insert({ name, (UniformHandle)uniforms.size() });
+        uniforms.push_back(info);
+    }
+}
+
+void ShaderProgram::bindUniformBlocks() {
+    // Blocks shared between programs and the binding point their buffer lives at
+    const std::pair<const char*, GLuint> sharedBlocks[] = {
+        { FrameUniforms::blockName, FrameUniforms::bindingPoint },
+        { TextureAtlas::blockName,  TextureAtlas::bindingPoint },
+    };
+
+    for (auto& [blockName, bindingPoint] : sharedBlocks) {
+        GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
+
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program, blockIndex, bindingPoint);
+        }
+    }
+}
+
+UniformHandle ShaderProgram::getUniformHandle(const std::string& name) {
+    ensureBuilt();
+
+    auto it = uniformHandles.find(name);
+    if (it == uniformHandles.end()) return -1;
+
+    return it->second;
+}
+
+const std::vector<ShaderProgram::UniformInfo>& ShaderProgram::getUniforms() {
+    ensureBuilt();
+    return uniforms;
+}
+
+bool ShaderProgram::updateUniformValue(UniformHandle handle, const void* value, std::size_t size) {
+    UniformInfo& info = uniforms[handle];
+
+    // Does not fit the slot, can't be cached
+    if (size > info.valueSize) return true;
+
+    std::uint8_t* cached = &uniformValues[info.valueOffset];
+    if (info.hasValue && std::memcmp(cached, value, size) == 0) return false;
+
+    std::memcpy(cached, value, size);
+    info.hasValue = true;
+    return true;
+}
+
+void ShaderProgram::uploadUniform(GLint location, const int& value)          { glProgramUniform1i(program, location, value); }
+void ShaderProgram::uploadUniform(GLint location, const unsigned int& value) { glProgramUniform1ui(program, location, value); }
+void ShaderProgram::uploadUniform(GLint location, const float& value)        { glProgramUniform1f(program, location, value); }
+void ShaderProgram::uploadUniform(GLint location, const glm::vec2& value)    { glProgramUniform2fv(program, location, 1, &value[0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::vec3& value)    { glProgramUniform3fv(program, location, 1, &value[0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::vec4& value)    { glProgramUniform4fv(program, location, 1, &value[0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::ivec2& value)   { glProgramUniform2iv(program, location, 1, &value[0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::ivec3& value)   { glProgramUniform3iv(program, location, 1, &value[0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::ivec4& value)   { glProgramUniform4iv(program, location, 1, &value[0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::mat3& value)    { glProgramUniformMatrix3fv(program, location, 1, GL_FALSE, &value[0][0]); }
+void ShaderProgram::uploadUniform(GLint location, const glm::mat4& value)    { glProgramUniformMatrix4fv(program, location, 1, GL_FALSE, &value[0][0]); }
+
+void ShaderProgram::uploadCachedValue(const UniformInfo& info) {
+    if (!info.hasValue || info.location < 0) return;
+
+    const void* value = &uniformValues[info.valueOffset];
+
+    switch (info.type) {
+        case GL_FLOAT:             glProgramUniform1fv(program, info.location, 1, (const GLfloat*)value); break;
+        case GL_FLOAT_VEC2:        glProgramUniform2fv(program, info.location, 1, (const GLfloat*)value); break;
+        case GL_FLOAT_VEC3:        glProgramUniform3fv(program, info.location, 1, (const GLfloat*)value); break;
+        case GL_FLOAT_VEC4:        glProgramUniform4fv(program, info.location, 1, (const GLfloat*)value); break;
+        case GL_INT_VEC2:          glProgramUniform2iv(program, info.location, 1, (const GLint*)value); break;
+        case GL_INT_VEC3:          glProgramUniform3iv(program, info.location, 1, (const GLint*)value); break;
+        case GL_INT_VEC4:          glProgramUniform4iv(program, info.location, 1, (const GLint*)value); break;
+        case GL_UNSIGNED_INT:      glProgramUniform1uiv(program, info.location, 1, (const GLuint*)value); break;
+        case GL_FLOAT_MAT3:        glProgramUniformMatrix3fv(program, info.location, 1, GL_FALSE, (const GLfloat*)value); break;
+        case GL_FLOAT_MAT4:        glProgramUniformMatrix4fv(program, info.location, 1, GL_FALSE, (const GLfloat*)value); break;
+        default:                   glProgramUniform1iv(program, info.location, 1, (const GLint*)value); break; // int, bool and samplers
+    }
+}
+
+void ShaderProgram::adoptProgram(ShaderProgram& rebuilt) {
+    ensureBuilt();
+
+    // Whoever bound the old program with use() would keep drawing with it until the next use()
+    GLint currentProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+
+    std::swap(program, rebuilt.program);
+
+    if ((GLuint)currentProgram == rebuilt.program) glUseProgram(program);
+
+    // Keep our handles: uniforms we already know keep their index, new ones are appended
+    // and ones the new program lost stay around with location -1
+    std::vector<UniformInfo> oldUniforms = std::move(uniforms);
+    std::vector<std::uint8_t> oldValues  = std::move(uniformValues);
+
+    uniforms.clear();
+    uniformValues.clear();
+
+    auto appendUniform = [this](UniformInfo info, const std::uint8_t* value) {
+        std::size_t offset = uniformValues.size();
+        uniformValues.resize(offset + info.valueSize);
+
+        if (info.hasValue) std::memcpy(&uniformValues[offset], value, info.valueSize);
+        info.valueOffset = offset;
+
+        uniforms.push_back(info);
+    };
+
+    for (auto& oldInfo : oldUniforms) {
+        UniformInfo info = oldInfo;
+
+        auto it = rebuilt.uniformHandles.find(oldInfo.name);
+        if (it == rebuilt.uniformHandles.end()) {
+            info.location = -1;
+        } else {
+            const UniformInfo& newInfo = rebuilt.uniforms[it->second];
+
+            info.location  = newInfo.location;
+            info.arraySize = newInfo.arraySize;
+
+            // A value of another type can't be carried over
+            if (newInfo.type != oldInfo.type) {
+                info.type      = newInfo.type;
+                info.valueSize = newInfo.valueSize;
+                info.hasValue  = false;
+            }
+        }
+
+        appendUniform(info, &oldValues[oldInfo.valueOffset]);
+    }
+
+    for (auto& newInfo : rebuilt.uniforms) {
+        if (uniformHandles.count(newInfo.name) != 0) continue;
+
+        uniformHandles.insert({ newInfo.name, (UniformHandle)uniforms.size() });
+        appendUniform(newInfo, nullptr);
+    }
+
+    for (auto& info : uniforms) {
+        uploadCachedValue(info);
+    }
+}
+
+ShaderProgram::UniformStats ShaderProgram::getUniformStats() {
+    return uniformStats;
+}
+
+void ShaderProgram::resetUniformStats() {
+    uniformStats = UniformStats();
+}
+
+void ShaderProgram::setBinaryCacheDirectory(std::string directory) {
+    binaryCacheDirectory = directory;
+}
+
+void ShaderProgram::setParallelCompileSupported(bool supported) {
+    parallelCompileSupported = supported;
+}
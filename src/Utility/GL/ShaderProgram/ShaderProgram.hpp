@@ -2,14 +2,94 @@
 
 #include "Utility/GL/Shader/Shader.hpp"
 
+#include <glm/glm.hpp>
+
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+
+// Index into the uniform table of a ShaderProgram, -1 for uniforms the program does not have
+using UniformHandle = int;
 
 class ShaderProgram {
+public:
+    struct UniformInfo {
+        std::string name;
+        GLint       location;
+        GLenum      type;
+        GLint       arraySize;
+
+        // Last uploaded value of the first element, lives in uniformValues
+        std::size_t valueOffset;
+        std::size_t valueSize;
+        bool        hasValue = false;
+    };
+
+    // Uniform uploads since the last resetUniformStats(), over every program
+    struct UniformStats {
+        std::size_t uploads = 0;
+        std::size_t elided  = 0;
+    };
 private:
     std::vector<Shader> shaders;
 
     GLuint program;
+
+    std::string buildLog;
+
+    // Outputs captured by transform feedback, interleaved into one buffer. Has to be known before linking.
+    std::vector<std::string> feedbackVaryings;
+
+    // State of a build started with beginBuild()
+    bool buildPending = false;
+    bool loadedFromBinary = false;
+    std::string binaryCacheKey;
+    std::chrono::steady_clock::time_point buildStartTime;
+
+    // Active uniforms reflected after linking, the last value set is cached to skip redundant uploads
+    std::vector<UniformInfo> uniforms;
+    std::unordered_map<std::string, UniformHandle> uniformHandles;
+    std::vector<std::uint8_t> uniformValues;
+
+    static UniformStats uniformStats;
+
+    void reflectUniforms();
+
+    // Point the uniform blocks shared by every program at their fixed binding points
+    void bindUniformBlocks();
+
+    // Stores value as the cached value of handle, false if it was cached already
+    bool updateUniformValue(UniformHandle handle, const void* value, std::size_t size);
+
+    // Upload the cached value of a uniform again, after the GL program changed
+    void uploadCachedValue(const UniformInfo& info);
+
+    void uploadUniform(GLint location, const int& value);
+    void uploadUniform(GLint location, const unsigned int& value);
+    void uploadUniform(GLint location, const float& value);
+    void uploadUniform(GLint location, const glm::vec2& value);
+    void uploadUniform(GLint location, const glm::vec3& value);
+    void uploadUniform(GLint location, const glm::vec4& value);
+    void uploadUniform(GLint location, const glm::ivec2& value);
+    void uploadUniform(GLint location, const glm::ivec3& value);
+    void uploadUniform(GLint location, const glm::ivec4& value);
+    void uploadUniform(GLint location, const glm::mat3& value);
+    void uploadUniform(GLint location, const glm::mat4& value);
+
+    // Directory program binaries are cached in, empty disables the cache
+    static std::string binaryCacheDirectory;
+
+    static bool parallelCompileSupported;
+
+    // Finish a pending build, a program that fails to build is fatal
+    void ensureBuilt();
+
+    std::string getBinaryCacheKey();
+    bool loadProgramBinary(const std::string& key);
+    void saveProgramBinary(const std::string& key);
 public:
     ShaderProgram(const ShaderProgram&) = delete; // non construction-copyable
     ShaderProgram& operator=(const ShaderProgram&) = delete; // non copyable
@@ -20,13 +100,73 @@ public:
     void addShader(Shader&& shader);
     std::vector<Shader>& getShaderList();
 
+    // Capture these outputs of the last vertex processing stage with transform feedback, call before building
+    void setFeedbackVaryings(std::vector<std::string> varyings);
+
     void linkProgram();
 
+    // Compile every attached shader and link them. When the binary cache has a program built from
+    // the same sources by the same driver, it is loaded instead and nothing is compiled.
+    // On failure getBuildLog() holds the log of the failing shader or of the link.
+    bool build();
+    std::string getBuildLog();
+
+    // build() split in two: beginBuild() only issues the compile and link commands so the driver can work
+    // on several programs at once, finishBuild() queries the results. use() and getUniformLocation()
+    // finish a pending build on their own.
+    void beginBuild();
+    bool finishBuild();
+
+    // Whether finishBuild() would return without waiting on the driver.
+    // Only known with GL_KHR_parallel_shader_compile, otherwise always true.
+    bool isBuildComplete();
+    bool isBuildPending();
+
     bool isProgramLinked();
     std::string getInfoLog();
 
     // Tell OpenGL to switch to this shader program;
     void use();
 
-    GLuint getUniformLocation(std::string location);
+    GLuint getUniformLocation(const std::string& name);
+
+    // Look a uniform up once and keep the handle, set() with a handle is a plain array lookup
+    UniformHandle getUniformHandle(const std::string& name);
+    const std::vector<UniformInfo>& getUniforms();
+
+    // Upload value to the uniform unless it already holds it. Uses glProgramUniform*,
+    // so the program does not need to be bound. Unknown uniforms are ignored like location -1 is.
+    template <typename T>
+    void set(UniformHandle handle, const T& value) {
+        ensureBuilt();
+        if (handle < 0 || handle >= (UniformHandle)uniforms.size()) return;
+
+        if (!updateUniformValue(handle, &value, sizeof(T))) {
+            uniformStats.elided++;
+            return;
+        }
+
+        uniformStats.uploads++;
+        uploadUniform(uniforms[handle].location, value);
+    }
+
+    template <typename T>
+    void set(const std::string& name, const T& value) {
+        set(getUniformHandle(name), value);
+    }
+
+    void set(UniformHandle handle, bool value) {
+        set(handle, (int)value);
+    }
+
+    // Take over the GL program of rebuilt, a finished build of this program with changed sources.
+    // Used to hot reload: everyone holding this program draws with the new one from now on, handed out
+    // uniform handles stay valid and the values set through them are re-applied.
+    void adoptProgram(ShaderProgram& rebuilt);
+
+    static UniformStats getUniformStats();
+    static void resetUniformStats();
+
+    static void setBinaryCacheDirectory(std::string directory);
+    static void setParallelCompileSupported(bool supported);
 };
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Utility/GL/GLObjectCounter/GLObjectCounter.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+// Ring buffer for data that is rewritten every frame (moving instances, debug lines, ...).
+// The storage is split into regionCount frame regions and every region is guarded by a fence,
+// so the CPU never writes memory the GPU may still be reading and the driver never has to
+// stall or orphan the buffer.
+//
+// Uses immutable persistent/coherent storage on GL 4.4+, and falls back to an unsynchronized
+// glMapBufferRange of the current region on GL 4.1.
+template <typename T>
+class StreamBuffer {
+private:
+    GLuint buffer;
+
+    std::size_t regionCapacity;
+    std::size_t regionCount;
+    std::size_t currentRegion = 0;
+
+    std::vector<GLsync> fences;
+
+    bool persistent = false;
+    T*   persistentMapping = nullptr;
+    T*   frameMapping = nullptr;
+
+    void waitForRegion(std::size_t region) {
+        GLsync fence = fences[region];
+        if (fence == nullptr) return;
+
+        GLbitfield flags = 0;
+        while (true) {
+            GLenum result = glClientWaitSync(fence, flags, 1000000); // 1ms
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) break;
+
+            // Make sure the fence actually gets submitted before waiting on it again
+            flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        }
+
+        glDeleteSync(fence);
+        fences[region] = nullptr;
+    }
+public:
+    StreamBuffer(const StreamBuffer&) = delete; // non construction-copyable
+    StreamBuffer& operator=(const StreamBuffer&) = delete; // non copyable
+
+    StreamBuffer(std::size_t capacity, std::size_t _regionCount = 3):
+        regionCapacity(capacity),
+        regionCount(_regionCount),
+        fences(_regionCount, nullptr)
+    {
+        glGenBuffers(1, &buffer);
+        GLObjectCounter::bufferCreated();
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        const GLsizeiptr totalSize = sizeof(T) * regionCapacity * regionCount;
+
+        if (GLAD_GL_VERSION_4_4) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+            glBufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+            persistentMapping = (T*)glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags);
+            persistent = persistentMapping != nullptr;
+        }
+
+        if (!persistent) {
+            glBufferData(GL_ARRAY_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+        }
+    }
+
+    ~StreamBuffer() {
+        for (GLsync fence : fences) {
+            if (fence != nullptr) glDeleteSync(fence);
+        }
+
+        if (persistent || frameMapping != nullptr) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+
+        glDeleteBuffers(1, &buffer);
+        GLObjectCounter::bufferDeleted();
+    }
+
+    // Wait until the GPU is done with the current frame region and hand it out for writing.
+    std::span<T> beginFrame() {
+        waitForRegion(currentRegion);
+
+        if (persistent) {
+            frameMapping = persistentMapping + currentRegion * regionCapacity;
+        } else {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            frameMapping = (T*)glMapBufferRange(
+                GL_ARRAY_BUFFER,
+                getFrameOffset(),
+                sizeof(T) * regionCapacity,
+                GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT
+            );
+        }
+
+        return std::span<T>(frameMapping, regionCapacity);
+    }
+
+    // Done writing the current region. On the fallback path the region has to be unmapped
+    // before GL commands may read from it (copies, draws), so call this before issuing them.
+    void endWrites() {
+        if (!persistent && frameMapping != nullptr) {
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        frameMapping = nullptr;
+    }
+
+    // Call after every command reading the current region has been issued.
+    // Fences the region and moves on to the next one.
+    void endFrame() {
+        endWrites();
+
+        fences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        currentRegion = (currentRegion + 1) % regionCount;
+    }
+
+    GLuint getBufferId() {
+        return buffer;
+    }
+
+    // Byte offset of the current frame region, for glVertexAttribPointer / glBindBufferRange
+    GLintptr getFrameOffset() const {
+        return sizeof(T) * regionCapacity * currentRegion;
+    }
+
+    // Element index of the current frame region, for first / baseInstance draw parameters
+    std::size_t getFrameFirstElement() const {
+        return regionCapacity * currentRegion;
+    }
+
+    // Elements per frame region
+    std::size_t capacity() const {
+        return regionCapacity;
+    }
+
+    bool isPersistentlyMapped() const {
+        return persistent;
+    }
+};
@@ -1,9 +1,21 @@
 #include "Texture.hpp"
 
-#include <stb/stb_image.h>
+#include "Utility/Image/Image.hpp"
+#include "Utility/GL/GLExtensions/GLExtensions.hpp"
 
+#include <iostream>
+#include <algorithm>
 #include <cstdint>
 
+// From EXT_texture_compression_s3tc, glad is generated without extensions
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 Texture::Texture() {
     glGenTextures(1, &textureId);
 }
@@ -11,23 +23,169 @@ Texture::~Texture() {
     glDeleteTextures(1, &textureId);
 }
 
-void Texture::loadFromFilePath(std::string path) {
-    int width, height, channels;
-	std::uint8_t* img = stbi_load(path.c_str(), &width, &height, nullptr, STBI_rgb_alpha);
+bool Texture::loadFromFilePath(std::string path) {
+    std::optional<Image> image = Image::loadFromFile(path);
+    if (!image) return false;
 
-    uploadTexture2DFromBuffer(img, width, height, GL_RGBA, GL_UNSIGNED_BYTE);
-
-    stbi_image_free(img);
+    uploadTexture2DFromBuffer(image->pixels.data(), image->width, image->height, GL_RGBA, GL_UNSIGNED_BYTE);
+    return true;
 }
 
 void Texture::uploadTexture2DFromBuffer(const void* data, std::size_t width, std::size_t height, GLenum format, GLenum type) {
+    allocateTexture2D(width, height);
+
+    uploadTexture2DRegion(data, 0, 0, width, height, format, type);
+    generateMipmaps();
+}
+
+void Texture::allocateTexture2D(std::size_t _width, std::size_t _height, GLsizei levels) {
+    if (levelCount != 0) {
+        glDeleteTextures(1, &textureId);
+        glGenTextures(1, &textureId);
+    }
+
+    width          = _width;
+    height         = _height;
+    levelCount     = levels == 0 ? getFullMipLevelCount(width, height) : levels;
+    internalFormat = GL_RGBA8;
+
+    glBindTexture(GL_TEXTURE_2D, textureId);
+
+    if (GLAD_GL_VERSION_4_2) {
+        glTexStorage2D(GL_TEXTURE_2D, levelCount, GL_RGBA8, width, height);
+    } else {
+        for (GLint level=0; level<levelCount; level++) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, std::max<std::size_t>(width >> level, 1), std::max<std::size_t>(height >> level, 1), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    }
+}
+
+void Texture::uploadTexture2DRegion(const void* data, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLenum format, GLenum type, GLint level) {
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, format, type, data);
+}
+
+void Texture::allocateCompressed2D(BlockFormat format, std::size_t _width, std::size_t _height, GLsizei levels) {
+    if (levelCount != 0) {
+        glDeleteTextures(1, &textureId);
+        glGenTextures(1, &textureId);
+    }
+
+    width          = _width;
+    height         = _height;
+    levelCount     = levels == 0 ? getFullMipLevelCount(width, height) : levels;
+    internalFormat = getCompressedInternalFormat(format);
+
     glBindTexture(GL_TEXTURE_2D, textureId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, format, type, data);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); 
+    if (GLAD_GL_VERSION_4_2) {
+        glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, width, height);
+    } else {
+        for (GLint level=0; level<levelCount; level++) {
+            const std::size_t levelWidth  = std::max<std::size_t>(width >> level, 1);
+            const std::size_t levelHeight = std::max<std::size_t>(height >> level, 1);
+
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, levelWidth, levelHeight, 0, getCompressedSize(format, levelWidth, levelHeight), nullptr);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    }
+}
+
+void Texture::uploadCompressed2DRegion(const void* data, std::size_t byteCount, std::size_t x, std::size_t y, std::size_t regionWidth, std::size_t regionHeight, GLint level) {
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, level, x, y, regionWidth, regionHeight, internalFormat, byteCount, data);
+}
+
+void Texture::uploadCompressed(const CompressedImage& image) {
+    const CompressedImage::Level& base = image.levels.front();
+
+    if (isBlockFormatSupported(image.format)) {
+        allocateCompressed2D(image.format, base.width, base.height, image.levels.size());
+
+        for (std::size_t level=0; level<image.levels.size(); level++) {
+            const CompressedImage::Level& info = image.levels[level];
+            uploadCompressed2DRegion(image.getLevelData(level), info.byteCount, 0, 0, info.width, info.height, level);
+        }
+        return;
+    }
+
+    allocateTexture2D(base.width, base.height, image.levels.size());
+
+    for (std::size_t level=0; level<image.levels.size(); level++) {
+        const CompressedImage::Level& info = image.levels[level];
+        Image decoded = decompressImage(image.getLevelData(level), info.width, info.height, image.format);
+
+        uploadTexture2DRegion(decoded.pixels.data(), 0, 0, info.width, info.height, GL_RGBA, GL_UNSIGNED_BYTE, level);
+    }
+}
+
+bool Texture::loadCompressedFromFilePath(std::string path, BlockFormat format) {
+    std::optional<CompressedImage> image = TextureCache::load(path, format);
+    if (!image) return false;
+
+    uploadCompressed(*image);
+    return true;
+}
+
+void Texture::generateMipmaps() {
+    if (levelCount <= 1) return;
+
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void Texture::swap(Texture& other) {
+    std::swap(textureId, other.textureId);
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+    std::swap(levelCount, other.levelCount);
+    std::swap(internalFormat, other.internalFormat);
 }
 
 GLuint Texture::getTextureId() {
     return textureId;
-}
\ No newline at end of file
+}
+
+std::size_t Texture::getWidth() const {
+    return width;
+}
+
+std::size_t Texture::getHeight() const {
+    return height;
+}
+
+GLsizei Texture::getLevelCount() const {
+    return levelCount;
+}
+
+GLsizei Texture::getFullMipLevelCount(std::size_t width, std::size_t height) {
+    std::size_t size = std::max<std::size_t>(std::max(width, height), 1);
+
+    GLsizei levels = 1;
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+bool Texture::isBlockFormatSupported(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1:
+        case BlockFormat::BC3:
+            return hasGLExtension("GL_EXT_texture_compression_s3tc");
+        case BlockFormat::BC7:
+            return GLAD_GL_VERSION_4_2 || hasGLExtension("GL_ARB_texture_compression_bptc");
+    }
+    return false;
+}
+
+GLenum Texture::getCompressedInternalFormat(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BlockFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+    return GL_RGBA8;
+}
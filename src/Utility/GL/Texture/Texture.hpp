@@ -2,18 +2,69 @@
 
 #include <glad/glad.h>
 
+#include "Utility/TextureCache/TextureCache.hpp"
+
 #include <string>
 
+// 2D RGBA texture with immutable storage and a mip chain, either RGBA8 or block compressed.
+// Sampling state (filtering, wrapping, anisotropy) is not part of the texture, bind a Sampler next to it.
 class Texture {
 private:
     GLuint textureId;
+    GLenum internalFormat = GL_RGBA8;
+
+    std::size_t width = 0;
+    std::size_t height = 0;
+    GLsizei     levelCount = 0;
 public:
+    Texture(const Texture&) = delete; // non construction-copyable
+    Texture& operator=(const Texture&) = delete; // non copyable
+
     Texture();
     ~Texture();
 
-    void loadFromFilePath(std::string path);
+    // Decode and upload on the calling thread, see TextureLoader for loading in the background.
+    // Leaves the texture untouched and returns false when the image can't be decoded.
+    bool loadFromFilePath(std::string path);
 
+    // Allocate storage, upload the image into level 0 and generate the rest of the mip chain
     void uploadTexture2DFromBuffer(const void* data, std::size_t width, std::size_t height, GLenum format, GLenum type);
 
+    // Allocate RGBA storage with levels mip levels (0 for the full chain) without uploading anything,
+    // fill it with uploadTexture2DRegion and generateMipmaps. Immutable storage can't be resized,
+    // so allocating again replaces the texture object and changes getTextureId().
+    void allocateTexture2D(std::size_t width, std::size_t height, GLsizei levels = 0);
+    void uploadTexture2DRegion(const void* data, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLenum format, GLenum type, GLint level = 0);
+
+    // Like allocateTexture2D for a block compressed format, fill it with uploadCompressed2DRegion.
+    // Only valid when isBlockFormatSupported(format).
+    void allocateCompressed2D(BlockFormat format, std::size_t width, std::size_t height, GLsizei levels = 0);
+
+    // Region of whole blocks, width and height may only be cut short at the edge of the level
+    void uploadCompressed2DRegion(const void* data, std::size_t byteCount, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLint level = 0);
+
+    // Upload every level of image. Decodes it on the CPU and stores RGBA8 when the driver can't sample the format.
+    void uploadCompressed(const CompressedImage& image);
+
+    // Load through the TextureCache, see there
+    bool loadCompressedFromFilePath(std::string path, BlockFormat format);
+
+    // Rebuild every level below 0 from level 0
+    void generateMipmaps();
+
+    // Exchange the GL texture and its size with other, everyone holding this Texture sees the other image from now on
+    void swap(Texture& other);
+
     GLuint getTextureId();
-};
\ No newline at end of file
+
+    std::size_t getWidth() const;
+    std::size_t getHeight() const;
+    GLsizei     getLevelCount() const;
+
+    // Levels down to 1x1
+    static GLsizei getFullMipLevelCount(std::size_t width, std::size_t height);
+
+    // Whether the driver takes format directly, needs a current context
+    static bool isBlockFormatSupported(BlockFormat format);
+    static GLenum getCompressedInternalFormat(BlockFormat format);
+};
@@ -0,0 +1,70 @@
+#include "TextureArray.hpp"
+
+#include "Utility/GL/Texture/Texture.hpp"
+
+#include <algorithm>
+
+TextureArray::TextureArray(std::size_t _width, std::size_t _height, std::size_t _layerCount, GLsizei levels):
+    width(_width),
+    height(_height),
+    layerCount(_layerCount),
+    levelCount(levels == 0 ? Texture::getFullMipLevelCount(_width, _height) : levels)
+{
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+
+    if (GLAD_GL_VERSION_4_2) {
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levelCount, GL_RGBA8, width, height, layerCount);
+    } else {
+        for (GLint level=0; level<levelCount; level++) {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max<std::size_t>(width >> level, 1), std::max<std::size_t>(height >> level, 1), layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    }
+}
+
+TextureArray::~TextureArray() {
+    glDeleteTextures(1, &textureId);
+}
+
+void TextureArray::uploadLayerRegion(const void* data, std::size_t layer, std::size_t x, std::size_t y, std::size_t regionWidth, std::size_t regionHeight, GLenum format, GLenum type, GLint level) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, x, y, layer, regionWidth, regionHeight, 1, format, type, data);
+}
+
+void TextureArray::generateMipmaps() {
+    if (levelCount <= 1) return;
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+void TextureArray::setMaxLevel(GLint level) {
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, std::clamp<GLint>(level, 0, levelCount - 1));
+}
+
+void TextureArray::bind(GLuint textureUnit) {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+}
+
+GLuint TextureArray::getTextureId() {
+    return textureId;
+}
+
+std::size_t TextureArray::getWidth() const {
+    return width;
+}
+
+std::size_t TextureArray::getHeight() const {
+    return height;
+}
+
+std::size_t TextureArray::getLayerCount() const {
+    return layerCount;
+}
+
+GLsizei TextureArray::getLevelCount() const {
+    return levelCount;
+}
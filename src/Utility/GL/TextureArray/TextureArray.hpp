@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+// RGBA GL_TEXTURE_2D_ARRAY with immutable storage and a mip chain.
+// Every layer has the same size, a shader picks the layer with the third texture coordinate,
+// so textures in different layers can be used by the same draw call.
+class TextureArray {
+private:
+    GLuint textureId;
+
+    std::size_t width;
+    std::size_t height;
+    std::size_t layerCount;
+    GLsizei     levelCount;
+public:
+    TextureArray(const TextureArray&) = delete; // non construction-copyable
+    TextureArray& operator=(const TextureArray&) = delete; // non copyable
+
+    // levels mip levels per layer, 0 for the full chain
+    TextureArray(std::size_t width, std::size_t height, std::size_t layerCount, GLsizei levels = 0);
+    ~TextureArray();
+
+    void uploadLayerRegion(const void* data, std::size_t layer, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLenum format, GLenum type, GLint level = 0);
+
+    // Rebuild every level below 0 of every layer from level 0, up to the max level
+    void generateMipmaps();
+
+    // Sample and generate only levels 0 .. level, clamped to the allocated levels
+    void setMaxLevel(GLint level);
+
+    void bind(GLuint textureUnit);
+
+    GLuint getTextureId();
+
+    std::size_t getWidth() const;
+    std::size_t getHeight() const;
+    std::size_t getLayerCount() const;
+    GLsizei     getLevelCount() const;
+};
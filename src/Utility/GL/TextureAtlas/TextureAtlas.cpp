@@ -0,0 +1,141 @@
+#include "TextureAtlas.hpp"
+
+#include "Utility/AssetCache/AssetCache.hpp"
+
+#include <stb/stb_image.h>
+
+#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+TextureAtlas::TextureAtlas(std::size_t pageSize, std::size_t pageCount, std::size_t _padding, GLsizei levels):
+    pages(pageSize, pageSize, pageCount, levels),
+    packers(pageCount, SkylinePacker(pageSize, pageSize)),
+    padding(_padding)
+{
+    // The block is declared with maxRegions entries, so the buffer always has to be that big
+    regionBuffer.allocate(maxRegions);
+}
+
+TextureAtlas::~TextureAtlas() {}
+
+std::optional<TextureRegion> TextureAtlas::add(const std::uint8_t* rgba, std::size_t width, std::size_t height) {
+    if (regions.size() == maxRegions) {
+        std::cout << "TextureAtlas: region table is full (" << maxRegions << " regions)\n";
+        return std::nullopt;
+    }
+
+    const std::size_t pageWidth  = pages.getWidth();
+    const std::size_t pageHeight = pages.getHeight();
+
+    if (width > pageWidth || height > pageHeight) {
+        std::cout << "TextureAtlas: " << width << "x" << height << " image does not fit a " << pageWidth << "x" << pageHeight << " page\n";
+        return std::nullopt;
+    }
+
+    // Padding is dropped where it would not fit the page, a page sized image takes the whole layer
+    const std::size_t paddedWidth  = std::min(width + 2*padding, pageWidth);
+    const std::size_t paddedHeight = std::min(height + 2*padding, pageHeight);
+
+    std::optional<SkylinePacker::Rect> rect;
+    std::size_t layer = 0;
+
+    for (; layer<packers.size(); layer++) {
+        rect = packers[layer].pack(paddedWidth, paddedHeight);
+        if (rect) break;
+    }
+
+    if (!rect) {
+        std::cout << "TextureAtlas: no page has room for a " << width << "x" << height << " image\n";
+        return std::nullopt;
+    }
+
+    const std::size_t offsetX = (paddedWidth - width) / 2;
+    const std::size_t offsetY = (paddedHeight - height) / 2;
+
+    // Extend the edge texels into the padding
+    std::vector<std::uint8_t> padded(paddedWidth * paddedHeight * 4);
+
+    for (std::size_t y=0; y<paddedHeight; y++) {
+        const std::size_t sourceY = std::clamp<std::ptrdiff_t>((std::ptrdiff_t)y - (std::ptrdiff_t)offsetY, 0, height - 1);
+        const std::uint8_t* sourceRow = rgba + sourceY * width * 4;
+        std::uint8_t* row = &padded[y * paddedWidth * 4];
+
+        for (std::size_t x=0; x<offsetX; x++) std::memcpy(row + x*4, sourceRow, 4);
+        std::memcpy(row + offsetX*4, sourceRow, width * 4);
+        for (std::size_t x=offsetX+width; x<paddedWidth; x++) std::memcpy(row + x*4, sourceRow + (width-1)*4, 4);
+    }
+
+    pages.uploadLayerRegion(padded.data(), layer, rect->x, rect->y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    if (paddedWidth < pageWidth || paddedHeight < pageHeight) sharesPages = true;
+
+    TextureRegion region;
+    region.index  = regions.size();
+    region.layer  = layer;
+    region.uvRect = glm::vec4(
+        (float)(rect->x + offsetX) / pageWidth,
+        (float)(rect->y + offsetY) / pageHeight,
+        (float)width / pageWidth,
+        (float)height / pageHeight
+    );
+    regions.push_back(region);
+
+    TextureRegionData data = { region.uvRect, glm::vec4((float)layer, 0, 0, 0) };
+    regionBuffer.update(region.index, std::span<const TextureRegionData>(&data, 1));
+
+    mipmapsDirty = true;
+    return region;
+}
+
+std::optional<TextureRegion> TextureAtlas::loadFromFilePath(const std::string& path) {
+    const std::string key = getAssetKey(path);
+
+    auto loaded = regionsByPath.find(key);
+    if (loaded != regionsByPath.end()) return regions[loaded->second];
+
+    int width, height;
+    std::uint8_t* img = stbi_load(path.c_str(), &width, &height, nullptr, STBI_rgb_alpha);
+
+    if (img == nullptr) {
+        std::cout << "Failed to load texture " << path << ": " << stbi_failure_reason() << '\n';
+        return std::nullopt;
+    }
+
+    auto region = add(img, width, height);
+    if (region) regionsByPath[key] = region->index;
+
+    stbi_image_free(img);
+    return region;
+}
+
+void TextureAtlas::bind(GLuint textureUnit) {
+    if (regionBuffer.isDirty()) regionBuffer.flush();
+
+    if (mipmapsDirty) {
+        // Padding halves with every level, once it is gone the levels mix whatever shares the page
+        pages.setMaxLevel(sharesPages ? (GLint)std::bit_width(padding) - 1 : pages.getLevelCount() - 1);
+        pages.generateMipmaps();
+        mipmapsDirty = false;
+    }
+
+    pages.bind(textureUnit);
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, regionBuffer.getBufferId());
+}
+
+const TextureRegion& TextureAtlas::getRegion(std::uint32_t index) const {
+    return regions[index];
+}
+
+std::size_t TextureAtlas::getRegionCount() const {
+    return regions.size();
+}
+
+float TextureAtlas::getOccupancy(std::size_t page) const {
+    return packers[page].getOccupancy();
+}
+
+TextureArray& TextureAtlas::getTextureArray() {
+    return pages;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Utility/GL/TextureArray/TextureArray.hpp"
+#include "Utility/GL/Buffer/Buffer.hpp"
+#include "Utility/SkylinePacker/SkylinePacker.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <string>
+#include <cstdint>
+
+// Where an image ended up inside a TextureAtlas
+struct TextureRegion {
+    std::uint32_t index;  // Into the TextureRegions block, this is what instances store
+    std::uint32_t layer;
+    glm::vec4     uvRect; // xy = offset, zw = size, in normalized page coordinates
+};
+
+// One entry of the TextureRegions block in the shaders, laid out as std140
+struct TextureRegionData {
+    glm::vec4 uvRect;
+    glm::vec4 layer; // x = array layer
+};
+
+// Many images in one texture array, so everything using them can be drawn with one call.
+// Images are packed into pages (the layers of the array) with a skyline packer; images the size
+// of a page simply take a whole layer. Every image gets a TextureRegion, and the region table is
+// uploaded into a uniform buffer so shaders can map a per-instance region index to array coordinates,
+// see shader/include/atlas.glsl.
+//
+// Packed images are surrounded by padding texels repeating their edge, so filtering and the first
+// log2(padding) mip levels don't bleed neighbouring images in. Below that they would, so as soon as an
+// image shares its page (with other images or with unfilled space) sampling stops at level log2(padding).
+class TextureAtlas {
+private:
+    TextureArray               pages;
+    std::vector<SkylinePacker> packers;
+    std::size_t                padding;
+
+    std::vector<TextureRegion>  regions;
+    std::unordered_map<std::string, std::uint32_t> regionsByPath; // Asset key -> region index
+    Buffer<TextureRegionData>   regionBuffer;
+
+    bool mipmapsDirty = false;
+    bool sharesPages  = false; // Some image does not take a whole page, see the level cap above
+public:
+    static constexpr GLuint      bindingPoint = 1;
+    static constexpr const char* blockName    = "TextureRegions";
+
+    // Has to match the array size in atlas.glsl
+    static constexpr std::size_t maxRegions = 256;
+
+    TextureAtlas(const TextureAtlas&) = delete; // non construction-copyable
+    TextureAtlas& operator=(const TextureAtlas&) = delete; // non copyable
+
+    TextureAtlas(std::size_t pageSize, std::size_t pageCount, std::size_t padding = 4, GLsizei levels = 0);
+    ~TextureAtlas();
+
+    // Pack an RGBA8 image into the first page with room for it.
+    // Returns nothing when no page has room or the region table is full.
+    std::optional<TextureRegion> add(const std::uint8_t* rgba, std::size_t width, std::size_t height);
+
+    // Same region for the same file, it's only decoded and packed the first time
+    std::optional<TextureRegion> loadFromFilePath(const std::string& path);
+
+    // Bind the pages to textureUnit and the region table to bindingPoint.
+    // Uploads regions and rebuilds the mip chain first if images were added since the last bind.
+    void bind(GLuint textureUnit);
+
+    const TextureRegion& getRegion(std::uint32_t index) const;
+    std::size_t getRegionCount() const;
+
+    // Fraction of a page covered by images, including their padding
+    float getOccupancy(std::size_t page) const;
+
+    TextureArray& getTextureArray();
+};
@@ -0,0 +1,66 @@
+#include "TextureLoader.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+std::array<std::uint8_t, 4> TextureLoader::placeholderColor = { 128, 128, 128, 255 };
+
+TextureLoader::TextureLoader(UploadQueue& _uploadQueue): uploadQueue(_uploadQueue) {}
+
+TextureLoader::~TextureLoader() {}
+
+static std::string getOptionsKey(const TextureLoadOptions& options) {
+    std::string key = options.flipVertically ? "flip" : "";
+    if (options.buildMipmapsOnWorker) key += ",workermips";
+    if (options.compression) key += std::string(",") + getBlockFormatName(*options.compression);
+
+    return key;
+}
+
+std::shared_ptr<Texture> TextureLoader::load(const std::string& path, TextureLoadOptions options) {
+    return textures.get(getAssetKey(path, getOptionsKey(options)), [&]() {
+        auto texture = std::make_shared<Texture>();
+        texture->uploadTexture2DFromBuffer(placeholderColor.data(), 1, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+
+        pendingLoads.push_back({ path, texture, uploadQueue.loadTexture(path, options) });
+
+        return texture;
+    });
+}
+
+void TextureLoader::update() {
+    std::erase_if(pendingLoads, [this](PendingLoad& load) {
+        if (load.upload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+        std::shared_ptr<Texture> uploaded = load.upload.get();
+
+        if (uploaded == nullptr) {
+            std::cout << "TextureLoader: keeping the placeholder for " << load.path << '\n';
+            failedCount++;
+            return true;
+        }
+
+        // Nobody may hold the texture anymore, then the upload is simply dropped
+        if (auto texture = load.texture.lock()) texture->swap(*uploaded);
+
+        loadedCount++;
+        return true;
+    });
+}
+
+std::size_t TextureLoader::getPendingCount() const {
+    return pendingLoads.size();
+}
+
+std::size_t TextureLoader::getLoadedCount() const {
+    return loadedCount;
+}
+
+std::size_t TextureLoader::getFailedCount() const {
+    return failedCount;
+}
+
+AssetCache<Texture>::Stats TextureLoader::getCacheStats() const {
+    return textures.getStats();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Utility/GL/UploadQueue/UploadQueue.hpp"
+#include "Utility/GL/Texture/Texture.hpp"
+#include "Utility/AssetCache/AssetCache.hpp"
+
+#include <vector>
+#include <future>
+#include <memory>
+#include <string>
+#include <array>
+#include <cstdint>
+
+// Loads image files into textures in the background.
+// load() returns right away with a texture showing a one texel placeholder. The image is decoded
+// on the upload queue's workers, copied within its frame budget and swapped into that same texture
+// by update() once the GPU has it, so nothing has to re-fetch the handle. Failed loads keep the placeholder.
+// Loading a path again with the same options returns the texture already held instead of a copy.
+class TextureLoader {
+private:
+    struct PendingLoad {
+        std::string                           path;
+        std::weak_ptr<Texture>                texture;
+        std::future<std::shared_ptr<Texture>> upload;
+    };
+
+    UploadQueue& uploadQueue;
+    std::vector<PendingLoad> pendingLoads;
+
+    AssetCache<Texture> textures;
+
+    std::size_t loadedCount = 0;
+    std::size_t failedCount = 0;
+public:
+    // RGBA color of textures that are still loading
+    static std::array<std::uint8_t, 4> placeholderColor;
+
+    TextureLoader(const TextureLoader&) = delete; // non construction-copyable
+    TextureLoader& operator=(const TextureLoader&) = delete; // non copyable
+
+    TextureLoader(UploadQueue& uploadQueue);
+    ~TextureLoader();
+
+    std::shared_ptr<Texture> load(const std::string& path, TextureLoadOptions options = {});
+
+    // Swap finished images into their textures, call once per frame after UploadQueue::process()
+    void update();
+
+    std::size_t getPendingCount() const;
+    std::size_t getLoadedCount() const;
+    std::size_t getFailedCount() const;
+
+    AssetCache<Texture>::Stats getCacheStats() const;
+};
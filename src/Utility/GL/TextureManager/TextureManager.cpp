@@ -0,0 +1,225 @@
+#include "TextureManager.hpp"
+
+#include "Utility/GL/TextureLoader/TextureLoader.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+bool TextureManager::Entry::isUploading() const {
+    return upload.valid();
+}
+
+std::size_t TextureManager::Entry::getTargetLevel() const {
+    return isUploading() ? uploadLevel : residentLevel;
+}
+
+TextureManager::TextureManager(ThreadPool& _threadPool, UploadQueue& _uploadQueue, std::size_t _budgetBytes):
+    threadPool(_threadPool), uploadQueue(_uploadQueue), budgetBytes(_budgetBytes) {}
+
+TextureManager::~TextureManager() {}
+
+std::shared_ptr<Texture> TextureManager::load(const std::string& path, BlockFormat format) {
+    return textures.get(getAssetKey(path, getBlockFormatName(format)), [&]() {
+        auto texture = std::make_shared<Texture>();
+        texture->uploadTexture2DFromBuffer(TextureLoader::placeholderColor.data(), 1, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+
+        // A texture freed since the last update may have had the same address
+        Entry& entry = entries[texture.get()];
+        entry = Entry();
+        entry.path       = path;
+        entry.texture    = texture;
+        entry.sourceLoad = threadPool.submit([path, format]() { return TextureCache::load(path, format); });
+
+        return texture;
+    });
+}
+
+void TextureManager::requestSize(const Texture& texture, float screenPixels) {
+    auto it = entries.find(&texture);
+    if (it == entries.end()) return;
+
+    it->second.requestedPixels = std::max(it->second.requestedPixels, screenPixels);
+    it->second.lastUsedFrame   = frame;
+}
+
+std::size_t TextureManager::getRequiredLevel(const Entry& entry) const {
+    if (entry.requestedPixels <= 0) return entry.baselineLevel;
+
+    // Finest level with no more texels than pixels on screen, finer ones would only be minified away
+    const float texels = entry.source->levels.front().height;
+    if (entry.requestedPixels >= texels) return 0;
+
+    const std::size_t level = std::floor(std::log2(texels / entry.requestedPixels));
+    return std::min(level, entry.baselineLevel);
+}
+
+std::size_t TextureManager::getCommittedBytes() const {
+    std::size_t bytes = 0;
+
+    for (auto& [_, entry] : entries) {
+        if (entry.isResident || entry.isUploading()) bytes += entry.residentBytes[entry.getTargetLevel()];
+    }
+
+    return bytes;
+}
+
+void TextureManager::onSourceLoaded(Entry& entry) {
+    const CompressedImage& source = *entry.source;
+
+    // Drivers without the format get the levels decoded to RGBA8, which is what they then take up
+    const bool isSupported = Texture::isBlockFormatSupported(source.format);
+
+    entry.residentBytes.assign(source.levels.size() + 1, 0);
+    for (std::size_t level=source.levels.size(); level-- > 0;) {
+        const CompressedImage::Level& info = source.levels[level];
+        entry.residentBytes[level] = entry.residentBytes[level + 1] + (isSupported ? info.byteCount : info.width * info.height * 4);
+    }
+
+    entry.baselineLevel = source.levels.size() - 1;
+    for (std::size_t level=0; level<source.levels.size(); level++) {
+        if (std::max(source.levels[level].width, source.levels[level].height) <= baselineSize) {
+            entry.baselineLevel = level;
+            break;
+        }
+    }
+
+    startUpload(entry, entry.baselineLevel);
+}
+
+void TextureManager::startUpload(Entry& entry, std::size_t level) {
+    entry.uploadLevel = level;
+
+    std::shared_ptr<const CompressedImage> source = entry.source;
+
+    if (Texture::isBlockFormatSupported(source->format)) {
+        entry.upload = uploadQueue.uploadCompressedTexture([source, level]() {
+            return std::optional<CompressedImage>(source->getLevelRange(level));
+        });
+        return;
+    }
+
+    entry.upload = uploadQueue.uploadTexture([source, level]() {
+        std::vector<Image> levels;
+
+        for (std::size_t i=level; i<source->levels.size(); i++) {
+            const CompressedImage::Level& info = source->levels[i];
+            levels.push_back(decompressImage(source->getLevelData(i), info.width, info.height, source->format));
+        }
+
+        return levels;
+    });
+}
+
+void TextureManager::update() {
+    // Nobody draws these anymore, uploads still in flight are simply dropped
+    std::erase_if(entries, [](auto& item) { return item.second.texture.expired(); });
+
+    for (auto& [_, entry] : entries) {
+        if (entry.sourceLoad.valid() && entry.sourceLoad.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            std::optional<CompressedImage> source = entry.sourceLoad.get();
+
+            if (!source) {
+                std::cout << "TextureManager: keeping the placeholder for " << entry.path << '\n';
+                entry.failed = true;
+                continue;
+            }
+
+            entry.source = std::make_shared<const CompressedImage>(std::move(*source));
+            onSourceLoaded(entry);
+        }
+
+        if (entry.isUploading() && entry.upload.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            std::shared_ptr<Texture> uploaded = entry.upload.get();
+
+            if (uploaded == nullptr) {
+                std::cout << "TextureManager: failed to upload levels of " << entry.path << '\n';
+                continue;
+            }
+
+            if (auto texture = entry.texture.lock()) texture->swap(*uploaded);
+
+            if (entry.isResident && entry.uploadLevel < entry.residentLevel) streamedLevels += entry.residentLevel - entry.uploadLevel;
+            if (entry.isResident && entry.uploadLevel > entry.residentLevel) evictedLevels  += entry.uploadLevel - entry.residentLevel;
+
+            entry.residentLevel = entry.uploadLevel;
+            entry.isResident    = true;
+        }
+    }
+
+    // Only entries that are resident and settled can change levels
+    std::vector<Entry*> settledEntries;
+    for (auto& [_, entry] : entries) {
+        if (entry.isResident && !entry.isUploading()) settledEntries.push_back(&entry);
+    }
+
+    std::size_t committedBytes = getCommittedBytes();
+
+    // Over budget drop levels finer than needed, least recently used textures first
+    if (committedBytes > budgetBytes) {
+        std::sort(settledEntries.begin(), settledEntries.end(), [](const Entry* a, const Entry* b) { return a->lastUsedFrame < b->lastUsedFrame; });
+
+        for (Entry* entry : settledEntries) {
+            if (committedBytes <= budgetBytes) break;
+
+            const std::size_t requiredLevel = getRequiredLevel(*entry);
+
+            std::size_t level = entry->residentLevel;
+            while (level < requiredLevel && committedBytes > budgetBytes) {
+                committedBytes -= entry->residentBytes[level] - entry->residentBytes[level + 1];
+                level++;
+            }
+
+            if (level != entry->residentLevel) startUpload(*entry, level);
+        }
+    }
+
+    // Stream in what is drawn this frame, largest on screen first, as far as the budget goes
+    std::sort(settledEntries.begin(), settledEntries.end(), [](const Entry* a, const Entry* b) { return a->requestedPixels > b->requestedPixels; });
+
+    for (Entry* entry : settledEntries) {
+        if (entry->isUploading() || entry->lastUsedFrame != frame) continue;
+
+        const std::size_t requiredLevel = getRequiredLevel(*entry);
+
+        std::size_t level = entry->residentLevel;
+        while (level > requiredLevel && committedBytes + entry->residentBytes[level - 1] - entry->residentBytes[entry->residentLevel] <= budgetBytes) {
+            level--;
+        }
+
+        if (level != entry->residentLevel) {
+            committedBytes += entry->residentBytes[level] - entry->residentBytes[entry->residentLevel];
+            startUpload(*entry, level);
+        }
+    }
+
+    // Requests are per frame
+    for (auto& [_, entry] : entries) entry.requestedPixels = 0;
+    frame++;
+}
+
+void TextureManager::setBudget(std::size_t _budgetBytes) {
+    budgetBytes = _budgetBytes;
+}
+
+TextureManager::Stats TextureManager::getStats() const {
+    Stats stats;
+    stats.budgetBytes    = budgetBytes;
+    stats.textureCount   = entries.size();
+    stats.streamedLevels = streamedLevels;
+    stats.evictedLevels  = evictedLevels;
+    stats.cache          = textures.getStats();
+
+    for (auto& [_, entry] : entries) {
+        if (entry.isResident) stats.residentBytes += entry.residentBytes[entry.residentLevel];
+        if (entry.isUploading() || entry.sourceLoad.valid()) stats.pendingUploads++;
+    }
+
+    return stats;
+}
+
+float TextureManager::getScreenSize(float worldSize, float distance, const glm::mat4& projection, float viewportHeight) {
+    // projection[1][1] is the cotangent of half the vertical field of view
+    return worldSize * projection[1][1] / std::max(distance, 1e-4f) * viewportHeight * 0.5f;
+}
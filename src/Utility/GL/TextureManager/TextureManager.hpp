@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Utility/ThreadPool/ThreadPool.hpp"
+#include "Utility/GL/UploadQueue/UploadQueue.hpp"
+#include "Utility/GL/Texture/Texture.hpp"
+#include "Utility/TextureCache/TextureCache.hpp"
+#include "Utility/AssetCache/AssetCache.hpp"
+
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <cstdint>
+
+// Keeps the textures it loads within a memory budget by streaming mip levels in and out.
+//
+// Every texture is baked into the TextureCache and only its mip chain from some level down is
+// resident on the GPU. Each frame the textures that are drawn report how many pixels they cover on
+// screen through requestSize(), which picks the finest level worth having. update() streams in
+// finer levels for textures that are drawn, and when that goes over the budget drops the finest levels of
+// the textures used least recently first. Levels at or below baselineSize are always resident.
+//
+// Immutable storage can't free single levels, so changing the resident levels uploads the new chain
+// into a new texture and swaps it into the handle from load(), like TextureLoader does.
+// Loading a path again in the same format returns the texture already held.
+class TextureManager {
+private:
+    struct Entry {
+        std::string            path;
+        std::weak_ptr<Texture> texture;
+
+        std::future<std::optional<CompressedImage>> sourceLoad;
+        std::shared_ptr<const CompressedImage>       source;
+        bool failed = false;
+
+        // Bytes on the GPU with every level from the index down resident
+        std::vector<std::size_t> residentBytes;
+
+        std::size_t baselineLevel = 0;
+        std::size_t residentLevel = 0; // Only meaningful once isResident
+        bool isResident = false;
+
+        // Largest screen size requested since the last update, 0 when not drawn
+        float         requestedPixels = 0;
+        std::uint64_t lastUsedFrame = 0;
+
+        std::future<std::shared_ptr<Texture>> upload;
+        std::size_t uploadLevel = 0;
+
+        bool isUploading() const;
+
+        // The level the entry ends up at once its upload is through
+        std::size_t getTargetLevel() const;
+    };
+
+    ThreadPool&  threadPool;
+    UploadQueue& uploadQueue;
+
+    std::size_t budgetBytes;
+
+    std::unordered_map<const Texture*, Entry> entries;
+    AssetCache<Texture> textures;
+    std::uint64_t frame = 1;
+
+    std::size_t streamedLevels = 0;
+    std::size_t evictedLevels = 0;
+
+    std::size_t getRequiredLevel(const Entry& entry) const;
+
+    // Bytes of every entry at its target level, what the budget is held against
+    std::size_t getCommittedBytes() const;
+
+    void onSourceLoaded(Entry& entry);
+    void startUpload(Entry& entry, std::size_t level);
+public:
+    // Levels whose larger side is at most this many texels stay resident
+    static constexpr std::size_t baselineSize = 64;
+
+    struct Stats {
+        std::size_t residentBytes = 0;
+        std::size_t budgetBytes = 0;
+        std::size_t textureCount = 0;
+        std::size_t pendingUploads = 0;
+        std::size_t streamedLevels = 0; // Totals since construction
+        std::size_t evictedLevels = 0;
+
+        AssetCache<Texture>::Stats cache;
+    };
+
+    TextureManager(const TextureManager&) = delete; // non construction-copyable
+    TextureManager& operator=(const TextureManager&) = delete; // non copyable
+
+    TextureManager(ThreadPool& threadPool, UploadQueue& uploadQueue, std::size_t budgetBytes);
+    ~TextureManager();
+
+    // Texture showing a placeholder until the baseline levels are uploaded, finer levels follow on demand
+    std::shared_ptr<Texture> load(const std::string& path, BlockFormat format = BlockFormat::BC7);
+
+    // Texture is drawn this frame covering screenPixels pixels vertically
+    void requestSize(const Texture& texture, float screenPixels);
+
+    // Stream levels in and out, call once per frame after UploadQueue::process()
+    void update();
+
+    void setBudget(std::size_t budgetBytes);
+    Stats getStats() const;
+
+    // Height in pixels of something worldSize tall at distance in front of a perspective camera
+    static float getScreenSize(float worldSize, float distance, const glm::mat4& projection, float viewportHeight);
+};
@@ -0,0 +1,330 @@
+#include "UploadQueue.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+
+UploadQueue::UploadQueue(ThreadPool& _threadPool, std::size_t _frameBudgetBytes, double _frameBudgetMs):
+    threadPool(_threadPool),
+    frameBudgetBytes(_frameBudgetBytes),
+    frameBudgetMs(_frameBudgetMs),
+    stagingBuffer(_frameBudgetBytes) {}
+
+UploadQueue::~UploadQueue() {
+    // Workers still hold on to this queue until their producer returns
+    for (auto& task : producerTasks) task.wait();
+
+    for (auto& job : copyingJobs) {
+        if (job->fence != nullptr) glDeleteSync(job->fence);
+    }
+    for (auto& job : fencedJobs) {
+        if (job->fence != nullptr) glDeleteSync(job->fence);
+    }
+}
+
+void UploadQueue::enqueue(std::shared_ptr<Job> job, std::function<void(Job&)> produce) {
+    queuedJobCount++;
+
+    producerTasks.push_back(threadPool.submit([this, job, produce]() {
+        produce(*job);
+
+        std::lock_guard lock(readyJobsMutex);
+        readyJobs.push_back(job);
+    }));
+}
+
+std::future<std::shared_ptr<Texture>> UploadQueue::loadTexture(std::string path, TextureLoadOptions options) {
+    if (options.compression && Texture::isBlockFormatSupported(*options.compression)) {
+        return uploadCompressedTexture([path, options]() {
+            return TextureCache::load(path, *options.compression, options.flipVertically);
+        });
+    }
+
+    return uploadTexture([path, options]() {
+        std::vector<Image> levels;
+
+        // Without driver support the cached blocks are still cheaper to decode than the source
+        if (options.compression) {
+            std::optional<CompressedImage> compressed = TextureCache::load(path, *options.compression, options.flipVertically);
+            if (!compressed) return levels;
+
+            for (std::size_t level=0; level<compressed->levels.size(); level++) {
+                const CompressedImage::Level& info = compressed->levels[level];
+                levels.push_back(decompressImage(compressed->getLevelData(level), info.width, info.height, compressed->format));
+            }
+            return levels;
+        }
+
+        std::optional<Image> image = Image::loadFromFile(path);
+        if (!image) return levels;
+
+        if (options.flipVertically) image->flipVertically();
+
+        if (options.buildMipmapsOnWorker) return buildMipChain(std::move(*image));
+
+        levels.push_back(std::move(*image));
+        return levels;
+    });
+}
+
+void UploadQueue::copyTextureChunk(Texture& texture, const std::vector<TextureLevel>& levels, std::size_t unitTexels, std::size_t unitBytes, GLintptr stagingOffset, std::size_t byteOffset, std::size_t byteCount, const RegionUpload& upload) {
+    const std::size_t chunkEnd = byteOffset + byteCount;
+
+    for (std::size_t level=0; level<levels.size(); level++) {
+        const TextureLevel& info = levels[level];
+
+        const std::size_t unitsWide = (info.width + unitTexels - 1) / unitTexels;
+        const std::size_t unitsHigh = (info.height + unitTexels - 1) / unitTexels;
+        const std::size_t rowBytes  = unitsWide * unitBytes;
+
+        std::size_t begin = std::max(byteOffset, info.byteOffset);
+        const std::size_t end = std::min(chunkEnd, info.byteOffset + rowBytes * unitsHigh);
+
+        while (begin < end) {
+            const std::size_t row    = (begin - info.byteOffset) / rowBytes;
+            const std::size_t column = (begin - info.byteOffset) % rowBytes / unitBytes;
+
+            std::size_t units, rows;
+            if (column != 0 || end - begin < rowBytes) {
+                units = std::min(unitsWide - column, (end - begin) / unitBytes);
+                rows  = 1;
+            } else {
+                units = unitsWide;
+                rows  = (end - begin) / rowBytes;
+            }
+
+            // Units at the right and bottom edge may be cut short
+            const std::size_t x = column * unitTexels;
+            const std::size_t y = row * unitTexels;
+            const std::size_t width  = std::min(units * unitTexels, info.width - x);
+            const std::size_t height = std::min(rows * unitTexels, info.height - y);
+            const std::size_t bytes  = units * rows * unitBytes;
+
+            upload(texture, (void*)(stagingOffset + (begin - byteOffset)), bytes, x, y, width, height, level);
+            begin += bytes;
+        }
+    }
+}
+
+std::future<std::shared_ptr<Texture>> UploadQueue::uploadTexture(std::function<std::vector<Image>()> producer) {
+    auto promise = std::make_shared<std::promise<std::shared_ptr<Texture>>>();
+    auto future  = promise->get_future();
+
+    auto job     = std::make_shared<Job>();
+    auto texture = std::make_shared<std::shared_ptr<Texture>>();
+    auto levels  = std::make_shared<std::vector<TextureLevel>>();
+
+    // Levels are back to back in the data, so chunks may end anywhere on a texel
+    job->chunkAlignment = 4;
+
+    job->create = [texture, levels](Job&) {
+        *texture = std::make_shared<Texture>();
+        (*texture)->allocateTexture2D(levels->front().width, levels->front().height, levels->size() == 1 ? 0 : levels->size());
+    };
+
+    // Upload straight out of the staging buffer bound as pixel unpack buffer
+    job->copy = [texture, levels](GLuint stagingBuffer, GLintptr stagingOffset, std::size_t byteOffset, std::size_t byteCount) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+
+        copyTextureChunk(**texture, *levels, 1, 4, stagingOffset, byteOffset, byteCount, [](Texture& texture, void* source, std::size_t, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLint level) {
+            texture.uploadTexture2DRegion(source, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, level);
+        });
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    };
+
+    // Without levels from the worker the mip chain is built on the GPU once level 0 is complete
+    job->finish = [texture, levels]() {
+        if (levels->size() == 1) (*texture)->generateMipmaps();
+    };
+
+    job->complete = [texture, promise]() { promise->set_value(*texture); };
+    job->fail     = [promise]() { promise->set_value(nullptr); };
+
+    enqueue(job, [producer, levels](Job& job) {
+        std::vector<Image> images = producer();
+
+        if (images.empty()) {
+            job.failed = true;
+            return;
+        }
+
+        std::size_t totalBytes = 0;
+        for (auto& image : images) {
+            levels->push_back({ image.width, image.height, totalBytes });
+            totalBytes += image.getByteSize();
+        }
+
+        job.data.reserve(totalBytes);
+        for (auto& image : images) {
+            job.data.insert(job.data.end(), image.pixels.begin(), image.pixels.end());
+        }
+    });
+
+    return future;
+}
+
+std::future<std::shared_ptr<Texture>> UploadQueue::uploadCompressedTexture(std::function<std::optional<CompressedImage>()> producer) {
+    auto promise = std::make_shared<std::promise<std::shared_ptr<Texture>>>();
+    auto future  = promise->get_future();
+
+    auto job     = std::make_shared<Job>();
+    auto texture = std::make_shared<std::shared_ptr<Texture>>();
+    auto levels  = std::make_shared<std::vector<TextureLevel>>();
+    auto format  = std::make_shared<BlockFormat>();
+
+    job->create = [texture, levels, format](Job&) {
+        *texture = std::make_shared<Texture>();
+        (*texture)->allocateCompressed2D(*format, levels->front().width, levels->front().height, levels->size());
+    };
+
+    job->copy = [texture, levels, format](GLuint stagingBuffer, GLintptr stagingOffset, std::size_t byteOffset, std::size_t byteCount) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+
+        copyTextureChunk(**texture, *levels, 4, getBlockBytes(*format), stagingOffset, byteOffset, byteCount, [](Texture& texture, void* source, std::size_t byteCount, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLint level) {
+            texture.uploadCompressed2DRegion(source, byteCount, x, y, width, height, level);
+        });
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    };
+
+    job->complete = [texture, promise]() { promise->set_value(*texture); };
+    job->fail     = [promise]() { promise->set_value(nullptr); };
+
+    enqueue(job, [producer, levels, format](Job& job) {
+        std::optional<CompressedImage> image = producer();
+
+        if (!image) {
+            job.failed = true;
+            return;
+        }
+
+        *format = image->format;
+        job.chunkAlignment = getBlockBytes(image->format);
+
+        for (auto& level : image->levels) {
+            levels->push_back({ level.width, level.height, level.byteOffset - image->levels.front().byteOffset });
+        }
+
+        // Copies out of the mapped cache file, the mapping is released with image
+        job.data.assign(image->getData(), image->getData() + image->getByteSize());
+    });
+
+    return future;
+}
+
+void UploadQueue::process() {
+    const auto processStartTime = std::chrono::steady_clock::now();
+
+    auto isOutOfTime = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processStartTime).count() > frameBudgetMs;
+    };
+
+    // Forget about producers that are done
+    std::erase_if(producerTasks, [](std::future<void>& task) {
+        return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+
+    // Create the GL objects of everything the workers finished
+    {
+        std::lock_guard lock(readyJobsMutex);
+
+        for (auto& job : readyJobs) {
+            if (job->failed) {
+                job->fail();
+                queuedJobCount--;
+                continue;
+            }
+
+            job->create(*job);
+            copyingJobs.push_back(job);
+        }
+        readyJobs.clear();
+    }
+
+    // Copy as much as the frame budget allows, in submission order
+    if (!copyingJobs.empty()) {
+        struct PendingCopy {
+            Job*        job;
+            GLintptr    stagingOffset;
+            std::size_t byteOffset;
+            std::size_t byteCount;
+        };
+        std::vector<PendingCopy> copies;
+
+        std::span<std::uint8_t> staging = stagingBuffer.beginFrame();
+        std::size_t used = 0;
+        bool outOfTime = false;
+
+        for (auto& job : copyingJobs) {
+            while (job->uploadedBytes < job->data.size()) {
+                // Something is copied every frame so uploads always make progress
+                if (used > 0 && isOutOfTime()) {
+                    outOfTime = true;
+                    break;
+                }
+
+                // Copy in pieces so the time budget is checked every now and then
+                std::size_t chunk = std::min({ job->data.size() - job->uploadedBytes, staging.size() - used, std::max(timeCheckBytes, job->chunkAlignment) });
+                chunk -= chunk % job->chunkAlignment;
+
+                if (chunk == 0) break;
+
+                std::memcpy(&staging[used], &job->data[job->uploadedBytes], chunk);
+                copies.push_back({ job.get(), stagingBuffer.getFrameOffset() + (GLintptr)used, job->uploadedBytes, chunk });
+
+                used += chunk;
+                job->uploadedBytes += chunk;
+            }
+
+            if (outOfTime) break;
+
+            if (job->uploadedBytes < job->data.size()) {
+                if (used == 0) {
+                    std::cout << "UploadQueue: " << job->chunkAlignment << " byte chunk does not fit the " << frameBudgetBytes << " byte frame budget!\n";
+                    std::exit(1);
+                }
+                break;
+            }
+        }
+
+        stagingBuffer.endWrites();
+
+        for (auto& copy : copies) {
+            copy.job->copy(stagingBuffer.getBufferId(), copy.stagingOffset, copy.byteOffset, copy.byteCount);
+        }
+
+        stagingBuffer.endFrame();
+
+        // Jobs are filled in order, so the finished ones are at the front
+        while (!copyingJobs.empty() && copyingJobs.front()->uploadedBytes == copyingJobs.front()->data.size()) {
+            auto job = copyingJobs.front();
+            copyingJobs.pop_front();
+
+            if (job->finish) job->finish();
+
+            job->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            job->data = std::vector<std::uint8_t>();
+
+            fencedJobs.push_back(job);
+        }
+    }
+
+    // Resolve uploads the GPU is done with
+    std::erase_if(fencedJobs, [this](std::shared_ptr<Job>& job) {
+        GLenum result = glClientWaitSync(job->fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) return false;
+
+        glDeleteSync(job->fence);
+        job->fence = nullptr;
+
+        job->complete();
+        queuedJobCount--;
+
+        return true;
+    });
+}
+
+bool UploadQueue::isIdle() const {
+    return queuedJobCount == 0;
+}
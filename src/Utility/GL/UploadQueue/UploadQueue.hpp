@@ -0,0 +1,157 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include "Utility/ThreadPool/ThreadPool.hpp"
+#include "Utility/GL/StreamBuffer/StreamBuffer.hpp"
+#include "Utility/GL/Buffer/Buffer.hpp"
+#include "Utility/GL/Texture/Texture.hpp"
+#include "Utility/Image/Image.hpp"
+#include "Utility/TextureCache/TextureCache.hpp"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <functional>
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+// How loadTexture prepares an image on the worker
+struct TextureLoadOptions {
+    bool flipVertically = false;
+
+    // Build the mip chain on the worker instead of with glGenerateMipmap after the upload.
+    // Uploads a third more data but keeps the work off the GPU and render thread.
+    bool buildMipmapsOnWorker = false;
+
+    // Load a block compressed mip chain through the TextureCache instead, decoded back to RGBA8
+    // on the worker when the driver lacks the format
+    std::optional<BlockFormat> compression;
+};
+
+// Creates textures and buffers without stalling the render thread.
+//
+// Workers of a ThreadPool produce the data (decode images, build vertex data) into CPU memory.
+// Once per frame process() copies at most frameBudgetBytes of it through a fenced staging buffer
+// (a pixel unpack buffer for textures) into the GL objects, so big loads are spread over several frames.
+// Copying also stops once frameBudgetMs of CPU time went into process().
+// A fence is placed after the last copy of a resource and its future resolves once the GPU passed it.
+class UploadQueue {
+private:
+    struct Job {
+        // Produced on a worker
+        std::vector<std::uint8_t> data;
+        bool failed = false;
+
+        // Copies are split on multiples of this (a texture row, an element)
+        std::size_t chunkAlignment = 1;
+
+        // Render thread callbacks
+        std::function<void(Job&)> create;
+        std::function<void(GLuint stagingBuffer, GLintptr stagingOffset, std::size_t byteOffset, std::size_t byteCount)> copy;
+        std::function<void()> finish; // Optional, after the last copy (mip generation, ...)
+        std::function<void()> complete;
+        std::function<void()> fail;
+
+        std::size_t uploadedBytes = 0;
+        GLsync fence = nullptr;
+    };
+
+    ThreadPool& threadPool;
+    std::vector<std::future<void>> producerTasks;
+
+    std::size_t frameBudgetBytes;
+    double      frameBudgetMs;
+
+    static constexpr std::size_t timeCheckBytes = 256 * 1024;
+
+    StreamBuffer<std::uint8_t> stagingBuffer;
+
+    // Jobs whose data is ready, filled by the workers
+    std::mutex readyJobsMutex;
+    std::vector<std::shared_ptr<Job>> readyJobs;
+
+    // Render thread only
+    std::deque<std::shared_ptr<Job>> copyingJobs;
+    std::vector<std::shared_ptr<Job>> fencedJobs;
+    std::size_t queuedJobCount = 0;
+
+    void enqueue(std::shared_ptr<Job> job, std::function<void(Job&)> produce);
+
+    // Where a mip level starts in the job data of a texture upload
+    struct TextureLevel {
+        std::size_t width;
+        std::size_t height;
+        std::size_t byteOffset;
+    };
+
+    using RegionUpload = std::function<void(Texture& texture, void* source, std::size_t byteCount, std::size_t x, std::size_t y, std::size_t width, std::size_t height, GLint level)>;
+
+    // Split a chunk of texture data into uploads of whole rows plus partial rows at either end, per level.
+    // Rows are made of units, texels or 4x4 blocks of unitBytes each.
+    static void copyTextureChunk(Texture& texture, const std::vector<TextureLevel>& levels, std::size_t unitTexels, std::size_t unitBytes, GLintptr stagingOffset, std::size_t byteOffset, std::size_t byteCount, const RegionUpload& upload);
+public:
+    UploadQueue(const UploadQueue&) = delete; // non construction-copyable
+    UploadQueue& operator=(const UploadQueue&) = delete; // non copyable
+
+    UploadQueue(ThreadPool& threadPool, std::size_t frameBudgetBytes = 4 * 1024 * 1024, double frameBudgetMs = 2.0);
+    ~UploadQueue();
+
+    // Call the following from the render thread
+
+    // Decode the image at path on a worker and upload it as an RGBA texture with a full mip chain.
+    // Resolves to nullptr when the image can't be decoded.
+    std::future<std::shared_ptr<Texture>> loadTexture(std::string path, TextureLoadOptions options = {});
+
+    // Run producer on a worker and upload the images it returns as the mip levels of a new texture.
+    // A single level gets the rest of the chain generated on the GPU, no levels fails the upload.
+    std::future<std::shared_ptr<Texture>> uploadTexture(std::function<std::vector<Image>()> producer);
+
+    // Same for a block compressed mip chain, which has to be in a format the driver supports.
+    // Nothing from the producer fails the upload.
+    std::future<std::shared_ptr<Texture>> uploadCompressedTexture(std::function<std::optional<CompressedImage>()> producer);
+
+    // Run producer on a worker and upload the elements it returns into a new buffer
+    template <typename T>
+    std::future<std::shared_ptr<Buffer<T>>> uploadBuffer(std::function<std::vector<T>()> producer) {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Buffer<T>>>>();
+        auto future  = promise->get_future();
+
+        auto job = std::make_shared<Job>();
+        auto buffer = std::make_shared<std::shared_ptr<Buffer<T>>>();
+        job->chunkAlignment = sizeof(T);
+
+        job->create = [buffer](Job& job) {
+            *buffer = std::make_shared<Buffer<T>>();
+            (*buffer)->allocate(job.data.size() / sizeof(T));
+        };
+
+        job->copy = [buffer](GLuint stagingBuffer, GLintptr stagingOffset, std::size_t byteOffset, std::size_t byteCount) {
+            glBindBuffer(GL_COPY_READ_BUFFER, stagingBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, (*buffer)->getBufferId());
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, stagingOffset, byteOffset, byteCount);
+        };
+
+        job->complete = [buffer, promise]() { promise->set_value(*buffer); };
+        job->fail     = [promise]() { promise->set_value(nullptr); };
+
+        enqueue(job, [producer](Job& job) {
+            std::vector<T> elements = producer();
+
+            job.data.resize(elements.size() * sizeof(T));
+            std::memcpy(job.data.data(), elements.data(), job.data.size());
+        });
+
+        return future;
+    }
+
+    // Copy ready data to the GPU within the frame budget and resolve finished uploads.
+    // Call once per frame on the thread owning the GL context.
+    void process();
+
+    // True when nothing is queued, copying or waiting on a fence
+    bool isIdle() const;
+};
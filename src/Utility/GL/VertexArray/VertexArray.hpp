@@ -2,6 +2,8 @@
 
 #include "glad/glad.h"
 
+#include "Utility/GL/VertexLayout/VertexLayout.hpp"
+
 class VertexArray {
 private:
     GLuint vertexArray;
@@ -13,4 +15,12 @@ public:
     ~VertexArray();
 
     void bindVertexArray();
-};
\ No newline at end of file
+
+    // Bake the attributes of Layout, read from buffer starting at byte offset, into this vertex array.
+    // Only needs to be done once, afterwards binding the vertex array restores the whole setup.
+    template <typename Layout>
+    void attachBuffer(GLuint buffer, GLintptr offset = 0) {
+        bindVertexArray();
+        Layout::apply(buffer, offset);
+    }
+};
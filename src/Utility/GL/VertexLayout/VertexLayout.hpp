@@ -0,0 +1,116 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// GL enum for a C++ component type
+template <typename T> struct GLTypeOf;
+template <> struct GLTypeOf<float>         { static constexpr GLenum value = GL_FLOAT; };
+template <> struct GLTypeOf<double>        { static constexpr GLenum value = GL_DOUBLE; };
+template <> struct GLTypeOf<std::int8_t>   { static constexpr GLenum value = GL_BYTE; };
+template <> struct GLTypeOf<std::uint8_t>  { static constexpr GLenum value = GL_UNSIGNED_BYTE; };
+template <> struct GLTypeOf<std::int16_t>  { static constexpr GLenum value = GL_SHORT; };
+template <> struct GLTypeOf<std::uint16_t> { static constexpr GLenum value = GL_UNSIGNED_SHORT; };
+template <> struct GLTypeOf<std::int32_t>  { static constexpr GLenum value = GL_INT; };
+template <> struct GLTypeOf<std::uint32_t> { static constexpr GLenum value = GL_UNSIGNED_INT; };
+
+// Component type and count of scalars and glm vectors
+template <typename T>
+struct VertexComponents {
+    using type = T;
+    static constexpr GLint count = 1;
+};
+
+template <glm::length_t L, typename T, glm::qualifier Q>
+struct VertexComponents<glm::vec<L, T, Q>> {
+    using type = T;
+    static constexpr GLint count = L;
+};
+
+// Description of a single vertex attribute.
+// Size is the number of bytes the attribute takes up in the buffer, which differs from
+// Components * sizeof(component) for packed types like GL_UNSIGNED_INT_2_10_10_10_REV.
+template <GLuint Location, GLint Components, GLenum Type, std::size_t Size, bool Normalized = false, GLuint Divisor = 0, bool Integer = false>
+struct VertexAttribute {
+    static constexpr GLuint      location   = Location;
+    static constexpr GLint       components = Components;
+    static constexpr GLenum      type       = Type;
+    static constexpr std::size_t size       = Size;
+    static constexpr bool        normalized = Normalized;
+    static constexpr GLuint      divisor    = Divisor;
+    static constexpr bool        integer    = Integer;
+};
+
+// Attribute read from a scalar or glm vector, e.g. Attribute<0, glm::vec3>
+template <GLuint Location, typename T, bool Normalized = false, GLuint Divisor = 0>
+using Attribute = VertexAttribute<
+    Location,
+    VertexComponents<T>::count,
+    GLTypeOf<typename VertexComponents<T>::type>::value,
+    sizeof(T),
+    Normalized,
+    Divisor
+>;
+
+// Per instance attribute, advances once per instance instead of once per vertex
+template <GLuint Location, typename T, bool Normalized = false>
+using InstanceAttribute = Attribute<Location, T, Normalized, 1>;
+
+// Integer attribute that reaches the shader as int/uint instead of being converted to float
+template <GLuint Location, typename T, GLuint Divisor = 0>
+using IntegerAttribute = VertexAttribute<
+    Location,
+    VertexComponents<T>::count,
+    GLTypeOf<typename VertexComponents<T>::type>::value,
+    sizeof(T),
+    false,
+    Divisor,
+    true
+>;
+
+// Attributes interleaved in a single buffer, in declaration order.
+// Use one layout per buffer for non-interleaved data.
+template <typename... Attributes>
+struct VertexLayout {
+    static constexpr std::size_t stride = (Attributes::size + ... + 0);
+
+    // Byte offset of the attribute at Index inside one vertex
+    template <std::size_t Index>
+    static constexpr std::size_t offsetOf() {
+        constexpr std::size_t sizes[] = { Attributes::size... };
+
+        std::size_t offset = 0;
+        for (std::size_t i=0; i<Index; i++) offset += sizes[i];
+        return offset;
+    }
+
+    // Point the attributes at buffer, starting at byte offset baseOffset.
+    // Records into the currently bound vertex array.
+    static void apply(GLuint buffer, GLintptr baseOffset = 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        applyAll(baseOffset, std::index_sequence_for<Attributes...>());
+    }
+private:
+    template <std::size_t... Indices>
+    static void applyAll(GLintptr baseOffset, std::index_sequence<Indices...>) {
+        (applyAttribute<Attributes>(baseOffset + offsetOf<Indices>()), ...);
+    }
+
+    template <typename Attr>
+    static void applyAttribute(GLintptr offset) {
+        glEnableVertexAttribArray(Attr::location);
+
+        if constexpr (Attr::integer) {
+            glVertexAttribIPointer(Attr::location, Attr::components, Attr::type, stride, (void*)offset);
+        } else {
+            glVertexAttribPointer(Attr::location, Attr::components, Attr::type, Attr::normalized ? GL_TRUE : GL_FALSE, stride, (void*)offset);
+        }
+
+        glVertexAttribDivisor(Attr::location, Attr::divisor);
+    }
+};
@@ -0,0 +1,95 @@
+#include "Image.hpp"
+
+#include <stb/stb_image.h>
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+static std::optional<Image> takeDecodedImage(std::uint8_t* img, int width, int height, const std::string& name) {
+    if (img == nullptr) {
+        std::cout << "Failed to load texture " << name << ": " << stbi_failure_reason() << '\n';
+        return std::nullopt;
+    }
+
+    Image image;
+    image.width  = width;
+    image.height = height;
+    image.pixels.assign(img, img + image.getByteSize());
+
+    stbi_image_free(img);
+    return image;
+}
+
+std::optional<Image> Image::loadFromFile(const std::string& path) {
+    int width, height;
+    std::uint8_t* img = stbi_load(path.c_str(), &width, &height, nullptr, STBI_rgb_alpha);
+
+    return takeDecodedImage(img, width, height, path);
+}
+
+std::optional<Image> Image::loadFromMemory(const void* data, std::size_t size, const std::string& name) {
+    int width, height;
+    std::uint8_t* img = stbi_load_from_memory((const stbi_uc*)data, (int)size, &width, &height, nullptr, STBI_rgb_alpha);
+
+    return takeDecodedImage(img, width, height, name);
+}
+
+void Image::flipVertically() {
+    const std::size_t rowBytes = width * 4;
+    std::vector<std::uint8_t> row(rowBytes);
+
+    for (std::size_t y=0; y<height/2; y++) {
+        std::uint8_t* top    = &pixels[y * rowBytes];
+        std::uint8_t* bottom = &pixels[(height - 1 - y) * rowBytes];
+
+        std::memcpy(row.data(), top, rowBytes);
+        std::memcpy(top, bottom, rowBytes);
+        std::memcpy(bottom, row.data(), rowBytes);
+    }
+}
+
+Image Image::downsample() const {
+    Image result;
+    result.width  = std::max<std::size_t>(width / 2, 1);
+    result.height = std::max<std::size_t>(height / 2, 1);
+    result.pixels.resize(result.getByteSize());
+
+    // On odd sizes the last texel is averaged with itself
+    for (std::size_t y=0; y<result.height; y++) {
+        const std::size_t y0 = std::min(y*2, height - 1);
+        const std::size_t y1 = std::min(y*2 + 1, height - 1);
+
+        for (std::size_t x=0; x<result.width; x++) {
+            const std::size_t x0 = std::min(x*2, width - 1);
+            const std::size_t x1 = std::min(x*2 + 1, width - 1);
+
+            for (std::size_t c=0; c<4; c++) {
+                const unsigned sum =
+                    pixels[(y0*width + x0)*4 + c] +
+                    pixels[(y0*width + x1)*4 + c] +
+                    pixels[(y1*width + x0)*4 + c] +
+                    pixels[(y1*width + x1)*4 + c];
+
+                result.pixels[(y*result.width + x)*4 + c] = (sum + 2) / 4;
+            }
+        }
+    }
+
+    return result;
+}
+
+std::size_t Image::getByteSize() const {
+    return width * height * 4;
+}
+
+std::vector<Image> buildMipChain(Image image) {
+    std::vector<Image> levels;
+    levels.push_back(std::move(image));
+
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        levels.push_back(levels.back().downsample());
+    }
+
+    return levels;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// RGBA8 image in CPU memory, rows from top to bottom.
+// Plain data without any GL state, so it can be produced and processed on worker threads.
+struct Image {
+    std::size_t width = 0;
+    std::size_t height = 0;
+    std::vector<std::uint8_t> pixels;
+
+    // Decode anything stb_image reads (JPEG, PNG, ...) and convert it to RGBA8.
+    // Returns nothing and prints the reason when decoding fails.
+    static std::optional<Image> loadFromFile(const std::string& path);
+    static std::optional<Image> loadFromMemory(const void* data, std::size_t size, const std::string& name = "memory");
+
+    void flipVertically();
+
+    // Half the size in both directions with a 2x2 box filter, like glGenerateMipmap does
+    Image downsample() const;
+
+    std::size_t getByteSize() const;
+};
+
+// image followed by every smaller level down to 1x1
+std::vector<Image> buildMipChain(Image image);
@@ -0,0 +1,60 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#if defined(__linux__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+        void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            data   = (const std::uint8_t*)mapping;
+            size   = fileStat.st_size;
+            mapped = true;
+        }
+    }
+
+    // The mapping stays valid without the descriptor
+    close(fd);
+
+    if (mapped) return;
+#endif
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return;
+
+    readData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    data = readData.data();
+    size = readData.size();
+}
+
+MappedFile::~MappedFile() {
+#if defined(__linux__) || defined(__APPLE__)
+    if (mapped) munmap((void*)data, size);
+#endif
+}
+
+bool MappedFile::isOpen() const {
+    return size > 0;
+}
+
+const std::uint8_t* MappedFile::getData() const {
+    return data;
+}
+
+std::size_t MappedFile::getSize() const {
+    return size;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Read only view of a whole file.
+// Memory mapped on platforms with mmap, so only the pages that are touched get read; read into memory elsewhere.
+class MappedFile {
+private:
+    const std::uint8_t* data = nullptr;
+    std::size_t         size = 0;
+
+    bool mapped = false;
+    std::vector<std::uint8_t> readData;
+public:
+    MappedFile(const MappedFile&) = delete; // non construction-copyable
+    MappedFile& operator=(const MappedFile&) = delete; // non copyable
+
+    MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // False when the file does not exist or can not be read, empty files count as not open
+    bool isOpen() const;
+
+    const std::uint8_t* getData() const;
+    std::size_t getSize() const;
+};
@@ -0,0 +1,65 @@
+#include "ParallelCuller.hpp"
+
+#include <algorithm>
+#include <future>
+#include <chrono>
+
+ParallelCuller::ParallelCuller(ThreadPool& _threadPool, std::size_t _chunkSize): threadPool(_threadPool), chunkSize(_chunkSize) {}
+
+ParallelCuller::~ParallelCuller() {}
+
+void ParallelCuller::forEachChunk(std::size_t chunkCount, const std::function<void(std::size_t chunk)>& task) {
+    // A few tasks per worker, so one slow worker doesn't hold everyone up, but not one per chunk
+    const std::size_t taskCount = std::min(chunkCount, threadPool.getThreadCount() * 4);
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(taskCount);
+
+    for (std::size_t t=0; t<taskCount; t++) {
+        tasks.push_back(threadPool.submit([&task, t, taskCount, chunkCount]() {
+            for (std::size_t chunk = chunkCount * t / taskCount; chunk < chunkCount * (t + 1) / taskCount; chunk++) task(chunk);
+        }));
+    }
+
+    for (auto& future : tasks) future.wait();
+}
+
+std::size_t ParallelCuller::cull(const Frustum& frustum, const SphereArrays& spheres, std::size_t count, const CompactFunction& compact) {
+    const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    scratchIndices.resize(count);
+    chunkVisibleCounts.assign(chunkCount, 0);
+    chunkOutputOffsets.assign(chunkCount, 0);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    forEachChunk(chunkCount, [&](std::size_t chunk) {
+        const std::size_t first = chunk * chunkSize;
+        chunkVisibleCounts[chunk] = cullSpheres(frustum, spheres, first, std::min(chunkSize, count - first), scratchIndices.data() + first);
+    });
+
+    const auto cullEndTime = std::chrono::steady_clock::now();
+
+    std::size_t visibleCount = 0;
+    for (std::size_t chunk=0; chunk<chunkCount; chunk++) {
+        chunkOutputOffsets[chunk] = visibleCount;
+        visibleCount += chunkVisibleCounts[chunk];
+    }
+
+    forEachChunk(chunkCount, [&](std::size_t chunk) {
+        if (chunkVisibleCounts[chunk] == 0) return;
+
+        compact(std::span<const std::uint32_t>(scratchIndices.data() + chunk * chunkSize, chunkVisibleCounts[chunk]), chunkOutputOffsets[chunk]);
+    });
+
+    lastStats.visibleCount = visibleCount;
+    lastStats.chunkCount   = chunkCount;
+    lastStats.cullMs       = std::chrono::duration<double, std::milli>(cullEndTime - startTime).count();
+    lastStats.compactMs    = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cullEndTime).count();
+
+    return visibleCount;
+}
+
+const ParallelCuller::Stats& ParallelCuller::getLastStats() const {
+    return lastStats;
+}
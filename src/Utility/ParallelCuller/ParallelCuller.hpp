@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Utility/FrustumCulling/FrustumCulling.hpp"
+#include "Utility/ThreadPool/ThreadPool.hpp"
+
+#include <vector>
+#include <span>
+#include <functional>
+#include <cstdint>
+
+// Builds the visible set of a large number of bounding spheres on the workers of a ThreadPool.
+//
+// The spheres are split into fixed size chunks and the work is a parallel prefix sum in three passes:
+//   1. every chunk is culled on a worker into its own slice of a scratch index list, giving a visible count per chunk
+//   2. an exclusive scan over the chunk counts (a handful of numbers) gives every chunk its output offset
+//   3. every chunk hands its visible indices and offset to compact on a worker, which writes
+//      the instance data straight to where it belongs in the output (a mapped StreamBuffer region)
+// so the output comes out in the same order a single threaded pass would give.
+class ParallelCuller {
+public:
+    // Called on the workers, once per chunk with visible spheres. Writes for visibleIndices go to outputOffset onwards.
+    using CompactFunction = std::function<void(std::span<const std::uint32_t> visibleIndices, std::size_t outputOffset)>;
+
+    struct Stats {
+        std::size_t visibleCount = 0;
+        std::size_t chunkCount = 0;
+        double cullMs = 0;    // Pass 1
+        double compactMs = 0; // Passes 2 and 3
+    };
+private:
+    ThreadPool& threadPool;
+    std::size_t chunkSize;
+
+    std::vector<std::uint32_t> scratchIndices;
+    std::vector<std::size_t>   chunkVisibleCounts;
+    std::vector<std::size_t>   chunkOutputOffsets;
+
+    Stats lastStats;
+
+    // Run task for every chunk on the pool and wait for all of them
+    void forEachChunk(std::size_t chunkCount, const std::function<void(std::size_t chunk)>& task);
+public:
+    ParallelCuller(const ParallelCuller&) = delete; // non construction-copyable
+    ParallelCuller& operator=(const ParallelCuller&) = delete; // non copyable
+
+    ParallelCuller(ThreadPool& threadPool, std::size_t chunkSize = 16 * 1024);
+    ~ParallelCuller();
+
+    // Cull spheres 0 to count - 1 and compact the visible ones, returns how many are visible
+    std::size_t cull(const Frustum& frustum, const SphereArrays& spheres, std::size_t count, const CompactFunction& compact);
+
+    const Stats& getLastStats() const;
+};
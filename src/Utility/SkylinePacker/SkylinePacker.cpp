@@ -0,0 +1,95 @@
+#include "SkylinePacker.hpp"
+
+#include <algorithm>
+
+SkylinePacker::SkylinePacker(std::size_t _width, std::size_t _height): width(_width), height(_height) {
+    clear();
+}
+
+std::optional<std::size_t> SkylinePacker::fitAt(std::size_t index, std::size_t rectWidth, std::size_t rectHeight) const {
+    if (skyline[index].x + rectWidth > width) return std::nullopt;
+
+    // The rectangle rests on the highest segment below it
+    std::size_t y = 0;
+    std::size_t remaining = rectWidth;
+
+    for (std::size_t i=index; remaining > 0; i++) {
+        y = std::max(y, skyline[i].y);
+        if (y + rectHeight > height) return std::nullopt;
+
+        remaining -= std::min(remaining, skyline[i].width);
+    }
+
+    return y;
+}
+
+std::optional<SkylinePacker::Rect> SkylinePacker::pack(std::size_t rectWidth, std::size_t rectHeight) {
+    if (rectWidth == 0 || rectHeight == 0) return std::nullopt;
+
+    std::size_t bestIndex = skyline.size();
+    std::size_t bestY     = height;
+    std::size_t bestWidth = width;
+
+    for (std::size_t i=0; i<skyline.size(); i++) {
+        auto y = fitAt(i, rectWidth, rectHeight);
+        if (!y) continue;
+
+        if (bestIndex == skyline.size() || *y < bestY || (*y == bestY && skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestY     = *y;
+            bestWidth = skyline[i].width;
+        }
+    }
+
+    if (bestIndex == skyline.size()) return std::nullopt;
+
+    Rect rect = { skyline[bestIndex].x, bestY, rectWidth, rectHeight };
+
+    // Raise the skyline under the new rectangle and cut off the segments it covers
+    skyline.insert(skyline.begin() + bestIndex, Segment{ rect.x, rect.y + rect.height, rect.width });
+
+    for (std::size_t i=bestIndex+1; i<skyline.size();) {
+        const std::size_t coveredEnd = rect.x + rect.width;
+        if (skyline[i].x >= coveredEnd) break;
+
+        const std::size_t segmentEnd = skyline[i].x + skyline[i].width;
+        if (segmentEnd <= coveredEnd) {
+            skyline.erase(skyline.begin() + i);
+            continue;
+        }
+
+        skyline[i].width = segmentEnd - coveredEnd;
+        skyline[i].x     = coveredEnd;
+        break;
+    }
+
+    // Merge neighbours of the same height
+    for (std::size_t i=0; i+1<skyline.size();) {
+        if (skyline[i].y == skyline[i+1].y) {
+            skyline[i].width += skyline[i+1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    usedArea += rect.width * rect.height;
+    return rect;
+}
+
+void SkylinePacker::clear() {
+    skyline = { Segment{ 0, 0, width } };
+    usedArea = 0;
+}
+
+float SkylinePacker::getOccupancy() const {
+    return (float)usedArea / (float)(width * height);
+}
+
+std::size_t SkylinePacker::getWidth() const {
+    return width;
+}
+
+std::size_t SkylinePacker::getHeight() const {
+    return height;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <cstddef>
+
+// Packs rectangles into a fixed size area by keeping track of the skyline, the top edge of
+// everything placed so far. A rectangle goes to the lowest spot it fits (bottom-left rule),
+// ties go to the spot that wastes the least width. Fast and tight enough for texture atlases,
+// but space below the skyline is never reused.
+class SkylinePacker {
+public:
+    struct Rect {
+        std::size_t x;
+        std::size_t y;
+        std::size_t width;
+        std::size_t height;
+    };
+private:
+    struct Segment {
+        std::size_t x;
+        std::size_t y;
+        std::size_t width;
+    };
+
+    std::size_t width;
+    std::size_t height;
+
+    std::vector<Segment> skyline;
+    std::size_t usedArea = 0;
+
+    // Height the rectangle would be placed at when its left edge is on segment index, or nothing if it doesn't fit
+    std::optional<std::size_t> fitAt(std::size_t index, std::size_t rectWidth, std::size_t rectHeight) const;
+public:
+    SkylinePacker(std::size_t width, std::size_t height);
+
+    std::optional<Rect> pack(std::size_t rectWidth, std::size_t rectHeight);
+
+    void clear();
+
+    // Fraction of the area covered by packed rectangles
+    float getOccupancy() const;
+
+    std::size_t getWidth() const;
+    std::size_t getHeight() const;
+};
@@ -0,0 +1,181 @@
+#include "TextureCache.hpp"
+
+#include "Utility/Utility.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <functional>
+
+std::string TextureCache::cacheDirectory = "./texturecache";
+
+// Bump when the layout or the encoders change, old files then simply stop matching
+static const std::uint32_t cacheFileVersion = 1;
+static const char cacheFileMagic[8] = { 'B', 'E', 'E', 'R', 'T', 'E', 'X', '\0' };
+
+struct CacheFileHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t format;
+    std::uint32_t levelCount;
+    std::uint32_t reserved;
+    std::uint64_t sourceHash;
+};
+
+struct CacheFileLevel {
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint64_t byteOffset; // From the start of the file
+    std::uint64_t byteCount;
+};
+
+const std::uint8_t* CompressedImage::getLevelData(std::size_t level) const {
+    const std::uint8_t* base = mappedFile ? mappedFile->getData() : ownedData.data();
+    return base + levels[level].byteOffset;
+}
+
+const std::uint8_t* CompressedImage::getData() const {
+    return getLevelData(0);
+}
+
+std::size_t CompressedImage::getByteSize() const {
+    return levels.back().byteOffset + levels.back().byteCount - levels.front().byteOffset;
+}
+
+CompressedImage CompressedImage::getLevelRange(std::size_t firstLevel) const {
+    CompressedImage range = *this;
+    range.levels.erase(range.levels.begin(), range.levels.begin() + firstLevel);
+    return range;
+}
+
+std::optional<CompressedImage> TextureCache::load(const std::string& path, BlockFormat format, bool flipVertically) {
+    auto source = std::make_shared<MappedFile>(path);
+    if (!source->isOpen()) {
+        std::cout << "Failed to load texture " << path << ": can't read the file\n";
+        return std::nullopt;
+    }
+
+    std::uint64_t sourceHash = hashBytes(source->getData(), source->getSize());
+
+    // Everything that changes the baked result goes into the file name
+    std::uint64_t key = sourceHash;
+    key = hashBytes(&cacheFileVersion, sizeof(cacheFileVersion), key);
+    key = hashBytes(&format, sizeof(format), key);
+    key = hashBytes(&flipVertically, sizeof(flipVertically), key);
+
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%016llx.btex", (unsigned long long)key);
+    const std::string cachePath = cacheDirectory + "/" + fileName;
+
+    if (!cacheDirectory.empty()) {
+        if (auto cached = read(cachePath, sourceHash)) return cached;
+    }
+
+    std::optional<Image> image = Image::loadFromMemory(source->getData(), source->getSize(), path);
+    if (!image) return std::nullopt;
+
+    if (flipVertically) image->flipVertically();
+
+    CompressedImage compressed = bake(std::move(*image), format);
+
+    if (!cacheDirectory.empty() && !write(cachePath, compressed, sourceHash)) {
+        std::cout << "TextureCache: failed to write " << cachePath << '\n';
+    }
+
+    return compressed;
+}
+
+CompressedImage TextureCache::bake(Image image, BlockFormat format) {
+    CompressedImage compressed;
+    compressed.format = format;
+
+    for (const Image& level : buildMipChain(std::move(image))) {
+        std::vector<std::uint8_t> blocks = compressImage(level, format);
+
+        compressed.levels.push_back({ level.width, level.height, compressed.ownedData.size(), blocks.size() });
+        compressed.ownedData.insert(compressed.ownedData.end(), blocks.begin(), blocks.end());
+    }
+
+    return compressed;
+}
+
+bool TextureCache::write(const std::string& cachePath, const CompressedImage& image, std::uint64_t sourceHash) {
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+    CacheFileHeader header = {};
+    std::memcpy(header.magic, cacheFileMagic, sizeof(header.magic));
+    header.version    = cacheFileVersion;
+    header.format     = (std::uint32_t)image.format;
+    header.levelCount = image.levels.size();
+    header.sourceHash = sourceHash;
+
+    // Level data starts right after the level table
+    const std::uint64_t dataOffset = sizeof(CacheFileHeader) + sizeof(CacheFileLevel) * image.levels.size();
+
+    std::vector<CacheFileLevel> levels;
+    for (auto& level : image.levels) {
+        levels.push_back({
+            (std::uint32_t)level.width,
+            (std::uint32_t)level.height,
+            dataOffset + level.byteOffset - image.levels.front().byteOffset,
+            level.byteCount
+        });
+    }
+
+    // Written under a temporary name first, so a crash never leaves half a file behind under the real one.
+    // The name is per thread since two workers may bake the same image at once.
+    const std::string temporaryPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)levels.data(), sizeof(CacheFileLevel) * levels.size());
+        file.write((const char*)image.getData(), image.getByteSize());
+
+        if (!file) return false;
+    }
+
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    return !error;
+}
+
+std::optional<CompressedImage> TextureCache::read(const std::string& cachePath, std::uint64_t sourceHash) {
+    auto file = std::make_shared<MappedFile>(cachePath);
+    if (!file->isOpen() || file->getSize() < sizeof(CacheFileHeader)) return std::nullopt;
+
+    CacheFileHeader header;
+    std::memcpy(&header, file->getData(), sizeof(header));
+
+    if (std::memcmp(header.magic, cacheFileMagic, sizeof(header.magic)) != 0 || header.version != cacheFileVersion || header.sourceHash != sourceHash) {
+        return std::nullopt;
+    }
+
+    if (header.levelCount == 0 || header.format > (std::uint32_t)BlockFormat::BC7) return std::nullopt;
+
+    const std::size_t tableEnd = sizeof(CacheFileHeader) + sizeof(CacheFileLevel) * header.levelCount;
+    if (file->getSize() < tableEnd) return std::nullopt;
+
+    CompressedImage image;
+    image.format     = (BlockFormat)header.format;
+    image.mappedFile = file;
+
+    std::uint64_t nextOffset = tableEnd;
+
+    for (std::uint32_t i=0; i<header.levelCount; i++) {
+        CacheFileLevel level;
+        std::memcpy(&level, file->getData() + sizeof(CacheFileHeader) + sizeof(CacheFileLevel) * i, sizeof(level));
+
+        // Levels have to be back to back and inside the file
+        if (level.byteOffset != nextOffset || level.byteOffset + level.byteCount > file->getSize()) return std::nullopt;
+        if (level.byteCount != getCompressedSize(image.format, level.width, level.height)) return std::nullopt;
+
+        nextOffset += level.byteCount;
+
+        image.levels.push_back({ level.width, level.height, level.byteOffset, level.byteCount });
+    }
+
+    return image;
+}
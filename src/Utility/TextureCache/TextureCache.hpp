@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Utility/BlockCompression/BlockCompression.hpp"
+#include "Utility/MappedFile/MappedFile.hpp"
+#include "Utility/Image/Image.hpp"
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <string>
+#include <cstdint>
+
+// Block compressed mip chain, either in its own memory or pointing into a mapped cache file
+struct CompressedImage {
+    struct Level {
+        std::size_t width;
+        std::size_t height;
+        std::size_t byteOffset;
+        std::size_t byteCount;
+    };
+
+    BlockFormat        format = BlockFormat::BC1;
+    std::vector<Level> levels;
+
+    // Where the level data lives, one of the two
+    std::shared_ptr<MappedFile> mappedFile;
+    std::vector<std::uint8_t>   ownedData;
+
+    const std::uint8_t* getLevelData(std::size_t level) const;
+
+    // Every level back to back, the way cache files and uploads store them
+    const std::uint8_t* getData() const;
+    std::size_t getByteSize() const;
+
+    // The chain from firstLevel down, sharing the mapped file (owned data is copied)
+    CompressedImage getLevelRange(std::size_t firstLevel) const;
+};
+
+// Compressed textures baked from image files, kept on disk between runs.
+//
+// A cache file is a small header, a table of mip levels and the blocks of every level (a
+// stripped down KTX2). It is named after the hash of the source file's bytes and the bake
+// options, so editing the image bakes it again. A hit is a memory mapped read of the cache file
+// instead of decoding, building mips and compressing.
+class TextureCache {
+public:
+    // Empty to never read or write cache files
+    static std::string cacheDirectory;
+
+    // Compressed mip chain for the image at path, baked and written to the cache when there is no
+    // up to date cache file. Nothing when the source can't be read or decoded.
+    static std::optional<CompressedImage> load(const std::string& path, BlockFormat format, bool flipVertically = false);
+
+    // Build the mip chain of image and compress every level
+    static CompressedImage bake(Image image, BlockFormat format);
+
+    static bool write(const std::string& cachePath, const CompressedImage& image, std::uint64_t sourceHash);
+
+    // Nothing when the file is missing, damaged or was baked from another source
+    static std::optional<CompressedImage> read(const std::string& cachePath, std::uint64_t sourceHash);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+// Fixed set of worker threads that run submitted tasks in order
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+
+    std::queue<std::function<void()>> tasks;
+    std::mutex              tasksMutex;
+    std::condition_variable tasksCondition;
+
+    bool stopping = false;
+
+    void workerLoop();
+public:
+    ThreadPool(const ThreadPool&) = delete; // non construction-copyable
+    ThreadPool& operator=(const ThreadPool&) = delete; // non copyable
+
+    ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    // Queue task to run on a worker, the returned future resolves with its result
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packagedTask->get_future();
+
+        {
+            std::lock_guard lock(tasksMutex);
+            tasks.push([packagedTask]() { (*packagedTask)(); });
+        }
+        tasksCondition.notify_one();
+
+        return future;
+    }
+
+    std::size_t getThreadCount() const;
+};
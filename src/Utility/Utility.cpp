@@ -8,4 +8,14 @@ std::string loadFile(std::string s) {
     std::stringstream ss;
     ss << fs.rdbuf();
     return ss.str();
+}
+
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash) {
+    const std::uint8_t* bytes = (const std::uint8_t*)data;
+
+    for (std::size_t i=0; i<size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
 }
\ No newline at end of file
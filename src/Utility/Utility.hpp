@@ -1,5 +1,9 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 
-std::string loadFile(std::string s);
\ No newline at end of file
+std::string loadFile(std::string s);
+
+// FNV-1a, pass the previous result as hash to continue hashing
+std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash = 14695981039346656037ull);
\ No newline at end of file